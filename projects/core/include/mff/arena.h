@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace mff {
+
+/**
+ * Statistics of arena (all of them are summed over the whole life of arena - besides
+ * bytes_reserved)
+ */
+struct ArenaStats {
+    // number of allocations served by the arena
+    std::size_t allocations = 0;
+    // bytes requested by the allocations
+    std::size_t bytes_allocated = 0;
+    // number of chunks requested from the upstream resource
+    std::size_t chunks = 0;
+    // bytes of chunks currently owned by the arena
+    std::size_t bytes_reserved = 0;
+    // number of resets
+    std::size_t resets = 0;
+};
+
+/**
+ * Monotonic (arena) memory resource - the memory is taken from chunks requested from upstream
+ * resource and it is never freed one by one (deallocation is no-op). All the memory is freed at
+ * once by reset (the largest chunk is kept, so arena which is reused for similar data does not
+ * have to request any more memory).
+ *
+ * The chunks are growing geometrically, so the number of upstream allocations is logarithmic to the
+ * size of the data.
+ *
+ * Can be used by any allocator aware container through std::pmr::polymorphic_allocator. It is not
+ * thread safe (but the memory can be deallocated from any thread, because it is no-op).
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+    /**
+     * Create the arena (no memory is requested before the first allocation)
+     * @param chunk_size size of the first chunk
+     * @param upstream the resource from which the chunks are requested
+     */
+    explicit Arena(
+        std::size_t chunk_size = 64 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Free all the allocated memory at once (all the objects allocated from the arena have to be
+     * destroyed or they can not be used anymore)
+     */
+    void reset();
+
+    /**
+     * @return statistics of this arena
+     */
+    const ArenaStats& get_stats() const;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    /**
+     * Header of chunk (stored at the start of the chunk memory)
+     */
+    struct Chunk {
+        Chunk* previous;
+        std::size_t size;
+    };
+
+    /**
+     * Request new chunk from upstream resource (so there is space for at least specified number of
+     * bytes with specified alignment)
+     * @param bytes
+     * @param alignment
+     */
+    void add_chunk(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * Start allocating from the start of the chunk
+     * @param chunk
+     */
+    void use_chunk(Chunk* chunk);
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t next_chunk_size_;
+
+    Chunk* chunks_ = nullptr;
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+
+    ArenaStats stats_ = {};
+};
+
+}
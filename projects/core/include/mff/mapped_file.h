@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mff {
+
+/**
+ * Read-only view of the whole file. Regular files are mapped to memory (the pages are loaded by
+ * the OS on demand and shared with the page cache, so the file is never copied), other files
+ * (pipes, character devices, ...) or files which can not be mapped are read into memory.
+ *
+ * The view is valid while the MappedFile lives.
+ */
+class MappedFile {
+public:
+    /**
+     * Open the file (throws std::system_error if it can not be opened or read)
+     * @param path
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @return the contents of the file
+     */
+    const char* data() const;
+
+    /**
+     * @return size of the file in bytes
+     */
+    std::size_t size() const;
+
+    /**
+     * @return the contents of the file as string
+     */
+    std::string_view view() const;
+
+    /**
+     * @return is the file mapped to memory (or was it read to buffer)?
+     */
+    bool is_mapped() const;
+
+private:
+    /**
+     * Read the whole file into buffer (the fallback if it can not be mapped)
+     * @param path
+     */
+    void read(const std::string& path);
+
+    /**
+     * Unmap the file (if it is mapped)
+     */
+    void release();
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_ = {};
+};
+
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mff {
+
+/**
+ * Pool of worker threads executing submitted tasks.
+ *
+ * Every worker has its own queue - tasks submitted from worker are pushed to its queue (and popped
+ * from the back, so the most recent work stays hot in cache), tasks submitted from other threads
+ * are distributed round-robin. Idle workers steal from the front of the other queues.
+ *
+ * The threads waiting for the tasks of the pool (parallel_for) are executing the pending tasks in
+ * meantime, so the pool can be used recursively.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * Create the pool and start the workers
+     * @param threads_count number of workers (hardware concurrency if 0)
+     */
+    explicit ThreadPool(std::size_t threads_count = 0);
+
+    /**
+     * Finish all the pending tasks and join the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @return number of worker threads
+     */
+    std::size_t get_threads_count() const;
+
+    /**
+     * Push the task to be executed by one of the workers
+     * @param task
+     */
+    void push(Task task);
+
+    /**
+     * Submit function to be executed by one of the workers
+     * @param fn
+     * @return future with result of the function (or the thrown exception)
+     */
+    template <typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using result_t = std::invoke_result_t<std::decay_t<F>>;
+
+        // std::function requires copyable callable so the packaged task is shared
+        auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(fn));
+        auto result = task->get_future();
+
+        push([task]() { (*task)(); });
+
+        return result;
+    }
+
+    /**
+     * Call fn(i) for every i in [0, count) on the workers (and the calling thread) and wait until
+     * all of them are finished. The indices are claimed dynamically in chunks, so the uneven work
+     * is balanced. The first thrown exception is rethrown in the calling thread.
+     * @param count
+     * @param fn
+     */
+    template <typename F>
+    void parallel_for(std::size_t count, F&& fn) {
+        if (count == 0) return;
+
+        // a few chunks per worker so the threads finishing early can take over the rest
+        std::size_t chunk_size = std::max<std::size_t>(1, count / (get_threads_count() * 8 + 1));
+        std::size_t chunks_count = (count + chunk_size - 1) / chunk_size;
+
+        struct State {
+            std::atomic<std::size_t> next_chunk = 0;
+            std::atomic<std::size_t> finished_chunks = 0;
+            std::mutex exception_mutex;
+            std::exception_ptr exception = nullptr;
+        };
+
+        auto state = std::make_shared<State>();
+
+        auto run_chunks = [state, count, chunk_size, chunks_count, &fn]() {
+            std::size_t chunk;
+
+            while ((chunk = state->next_chunk.fetch_add(1)) < chunks_count) {
+                try {
+                    auto end = std::min(count, (chunk + 1) * chunk_size);
+
+                    for (std::size_t i = chunk * chunk_size; i < end; i++) {
+                        fn(i);
+                    }
+                } catch (...) {
+                    std::lock_guard lock(state->exception_mutex);
+                    if (!state->exception) state->exception = std::current_exception();
+                }
+
+                state->finished_chunks.fetch_add(1);
+            }
+        };
+
+        auto helpers_count = std::min(get_threads_count(), chunks_count - 1);
+
+        for (std::size_t i = 0; i < helpers_count; i++) {
+            push(run_chunks);
+        }
+
+        // the calling thread works too (and executes other pending tasks until all chunks are done)
+        run_chunks();
+
+        while (state->finished_chunks.load() < chunks_count) {
+            if (!run_pending_task()) std::this_thread::yield();
+        }
+
+        if (state->exception) std::rethrow_exception(state->exception);
+    }
+
+    /**
+     * Execute one pending task in the calling thread (if there is any)
+     * @return was there a task to execute?
+     */
+    bool run_pending_task();
+
+private:
+    /**
+     * Queue of one worker
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * Take the task from the queue of worker (back of its own queue, front of the others)
+     * @param worker index of the worker taking the task (or the queue to start stealing from)
+     * @param own is the worker the owner of the queue with the index?
+     * @return the task (empty if there is none)
+     */
+    Task take_task(std::size_t worker, bool own);
+
+    /**
+     * Main loop of the worker thread
+     * @param worker
+     */
+    void run_worker(std::size_t worker);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_ = {};
+    std::vector<std::thread> threads_ = {};
+
+    std::atomic<std::size_t> next_queue_ = 0;
+    std::atomic<std::size_t> pending_tasks_ = 0;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+}
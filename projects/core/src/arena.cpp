@@ -0,0 +1,91 @@
+#include <mff/arena.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace mff {
+
+Arena::Arena(std::size_t chunk_size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), next_chunk_size_(chunk_size) {
+}
+
+Arena::~Arena() {
+    while (chunks_ != nullptr) {
+        auto previous = chunks_->previous;
+        upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+        chunks_ = previous;
+    }
+}
+
+void Arena::reset() {
+    stats_.resets++;
+
+    if (chunks_ == nullptr) return;
+
+    // the newest chunk is the largest one - it is kept and all the others are freed
+    auto chunk = chunks_->previous;
+
+    while (chunk != nullptr) {
+        auto previous = chunk->previous;
+        stats_.bytes_reserved -= chunk->size;
+        upstream_->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+        chunk = previous;
+    }
+
+    chunks_->previous = nullptr;
+    use_chunk(chunks_);
+}
+
+const ArenaStats& Arena::get_stats() const {
+    return stats_;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* result = current_;
+    std::size_t space = end_ - current_;
+
+    if (current_ == nullptr || std::align(alignment, bytes, result, space) == nullptr) {
+        add_chunk(bytes, alignment);
+
+        result = current_;
+        space = end_ - current_;
+        std::align(alignment, bytes, result, space);
+    }
+
+    current_ = static_cast<std::byte*>(result) + bytes;
+
+    stats_.allocations++;
+    stats_.bytes_allocated += bytes;
+
+    return result;
+}
+
+void Arena::do_deallocate(void*, std::size_t, std::size_t) {
+    // the memory is freed all at once by reset
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void Arena::add_chunk(std::size_t bytes, std::size_t alignment) {
+    // the header and the worst case padding have to fit in too
+    auto size = std::max(next_chunk_size_, sizeof(Chunk) + bytes + alignment);
+    auto memory = upstream_->allocate(size, alignof(std::max_align_t));
+
+    chunks_ = new(memory) Chunk{chunks_, size};
+    next_chunk_size_ = size * 2;
+
+    stats_.chunks++;
+    stats_.bytes_reserved += size;
+
+    use_chunk(chunks_);
+}
+
+void Arena::use_chunk(Chunk* chunk) {
+    current_ = reinterpret_cast<std::byte*>(chunk) + sizeof(Chunk);
+    end_ = reinterpret_cast<std::byte*>(chunk) + chunk->size;
+}
+
+}
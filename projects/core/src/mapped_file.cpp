@@ -0,0 +1,171 @@
+#include <mff/mapped_file.h>
+
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mff {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::system_error(
+            static_cast<int>(GetLastError()),
+            std::system_category(),
+            "Could not open file \"" + path + "\"");
+    }
+
+    LARGE_INTEGER file_size;
+
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        // the view keeps the mapping (and the file) alive, so the handles can be closed right away
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping != nullptr) {
+            auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+
+            if (view != nullptr) {
+                data_ = static_cast<const char*>(view);
+                size_ = static_cast<std::size_t>(file_size.QuadPart);
+                mapped_ = true;
+            }
+        }
+    }
+
+    CloseHandle(file);
+
+    if (!mapped_) read(path);
+}
+
+void MappedFile::release() {
+    if (mapped_) UnmapViewOfFile(data_);
+
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0) {
+        throw std::system_error(errno, std::generic_category(), "Could not open file \"" + path + "\"");
+    }
+
+    struct stat file_stat = {};
+
+    // empty files can not be mapped (and there is nothing to read)
+    if (fstat(file, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+        auto size = static_cast<std::size_t>(file_stat.st_size);
+        auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (view != MAP_FAILED) {
+            // the parsers are reading the file from the start to the end
+            madvise(view, size, MADV_SEQUENTIAL);
+
+            data_ = static_cast<const char*>(view);
+            size_ = size;
+            mapped_ = true;
+        }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(file);
+
+    if (!mapped_) read(path);
+}
+
+void MappedFile::release() {
+    if (mapped_) munmap(const_cast<char*>(data_), size_);
+
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+
+    release();
+
+    mapped_ = std::exchange(other.mapped_, false);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+    // the data of buffer are moved with it (the data of mapping are owned by the mapping)
+    data_ = mapped_ ? other.data_ : buffer_.data();
+    other.data_ = nullptr;
+
+    return *this;
+}
+
+const char* MappedFile::data() const {
+    return data_;
+}
+
+std::size_t MappedFile::size() const {
+    return size_;
+}
+
+std::string_view MappedFile::view() const {
+    return std::string_view(data_, size_);
+}
+
+bool MappedFile::is_mapped() const {
+    return mapped_;
+}
+
+void MappedFile::read(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+
+    if (!file) {
+        throw std::system_error(
+            std::make_error_code(std::errc::io_error),
+            "Could not read file \"" + path + "\"");
+    }
+
+    // the size of non-regular files is not known in advance, so they are read in chunks
+    char chunk[64 * 1024];
+
+    while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+        buffer_.insert(buffer_.end(), chunk, chunk + file.gcount());
+    }
+
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+
+}
@@ -0,0 +1,122 @@
+#include <mff/thread_pool.h>
+
+namespace mff {
+
+namespace {
+
+// the pool and the index of worker which is running on this thread
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+
+}
+
+ThreadPool::ThreadPool(std::size_t threads_count) {
+    if (threads_count == 0) {
+        threads_count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    queues_.reserve(threads_count);
+    for (std::size_t i = 0; i < threads_count; i++) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    threads_.reserve(threads_count);
+    for (std::size_t i = 0; i < threads_count; i++) {
+        threads_.emplace_back([this, i]() { run_worker(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(wake_mutex_);
+        stopping_ = true;
+    }
+
+    wake_.notify_all();
+
+    for (auto& thread: threads_) {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::get_threads_count() const {
+    return threads_.size();
+}
+
+void ThreadPool::push(Task task) {
+    // workers keep their own tasks local, the others are distributed
+    auto queue = current_pool == this
+        ? current_worker
+        : next_queue_.fetch_add(1) % queues_.size();
+
+    {
+        std::lock_guard lock(queues_[queue]->mutex);
+        queues_[queue]->tasks.push_back(std::move(task));
+    }
+
+    pending_tasks_.fetch_add(1);
+
+    {
+        // the workers check the pending tasks under this lock, so the notification is not lost
+        std::lock_guard lock(wake_mutex_);
+    }
+
+    wake_.notify_one();
+}
+
+bool ThreadPool::run_pending_task() {
+    auto own = current_pool == this;
+    auto task = take_task(own ? current_worker : next_queue_.load() % queues_.size(), own);
+
+    if (!task) return false;
+
+    task();
+
+    return true;
+}
+
+ThreadPool::Task ThreadPool::take_task(std::size_t worker, bool own) {
+    auto count = queues_.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        auto& queue = *queues_[(worker + i) % count];
+        std::lock_guard lock(queue.mutex);
+
+        if (queue.tasks.empty()) continue;
+
+        Task task;
+
+        if (own && i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        pending_tasks_.fetch_sub(1);
+
+        return task;
+    }
+
+    return {};
+}
+
+void ThreadPool::run_worker(std::size_t worker) {
+    current_pool = this;
+    current_worker = worker;
+
+    while (true) {
+        if (auto task = take_task(worker, true)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock lock(wake_mutex_);
+        wake_.wait(lock, [&]() { return stopping_ || pending_tasks_.load() > 0; });
+
+        if (stopping_ && pending_tasks_.load() == 0) return;
+    }
+}
+
+}
@@ -9,6 +9,7 @@
 #include <mff/leaf.h>
 #include <mff/graphics/memory.h>
 #include <mff/graphics/vulkan/instance.h>
+#include <mff/graphics/vulkan/pipeline_cache.h>
 #include <mff/graphics/vulkan/command_buffer/command_pool.h>
 #include <mff/graphics/vulkan/sync/fence.h>
 #include <mff/graphics/vulkan/sync/sync.h>
@@ -84,6 +85,11 @@ public:
      */
     const std::vector<std::string>& get_extensions() const;
 
+    /**
+     * @return features enabled for this device
+     */
+    const vk::PhysicalDeviceFeatures& get_enabled_features() const;
+
     /**
      * @return concrete vulkan Device
      */
@@ -94,6 +100,20 @@ public:
     mff::ObjectPool<mff::vulkan::Fence>* get_fence_pool();
     mff::ObjectPool<mff::vulkan::Semaphore>* get_semaphore_pool();
 
+    /**
+     * @return pipeline cache which should be used for all pipelines created on this device
+     */
+    const PipelineCache* get_pipeline_cache() const;
+
+    /**
+     * Replace the pipeline cache by one backed by file (it is loaded from the file if it was created
+     * by the same device and driver and saved back when the device is destroyed). Should be called
+     * before any pipeline is created.
+     * @param file_name
+     * @return
+     */
+    boost::leaf::result<void> load_pipeline_cache(const std::string& file_name);
+
     /**
      * Get command pool for this device and specified queue family (non-const because can allocate)
      * @param queue_family
@@ -108,12 +128,14 @@ public:
      *                       objects. Ignoring priorities because there is no guarantee by
      *                       specification that they will be used.
      * @param extensions A list of vulkan extensions to enable for new Device
+     * @param features Features to enable for new Device (have to be supported by PhysicalDevice)
      * @return
      */
     static boost::leaf::result<std::tuple<UniqueDevice, std::vector<SharedQueue>>> build(
         const PhysicalDevice* physical_device,
         const std::vector<const QueueFamily*>& queue_families,
-        const std::vector<std::string>& extensions
+        const std::vector<std::string>& extensions,
+        const vk::PhysicalDeviceFeatures& features = {}
     );
 
 private:
@@ -122,8 +144,11 @@ private:
     const Instance* instance_ = nullptr;
     const PhysicalDevice* physical_device_ = nullptr;
     vk::UniqueDevice handle_ = {};
+    // has to be destroyed before the handle (it is saved on destruction)
+    UniquePipelineCache pipeline_cache_ = nullptr;
     std::vector<std::string> layers_ = {};
     std::vector<std::string> extensions_ = {};
+    vk::PhysicalDeviceFeatures features_ = {};
     std::unordered_map<std::uint32_t, UniqueCommandPool> command_pools_ = {};
     ::vma::UniqueAllocator allocator_ = nullptr;
     mff::UniqueObjectPool<mff::vulkan::Semaphore> semaphores_pool_ = nullptr;
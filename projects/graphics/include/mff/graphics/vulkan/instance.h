@@ -127,6 +127,18 @@ public:
      */
     vk::PhysicalDeviceType get_type() const;
 
+    /**
+     * @see https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/chap4.html#VkPhysicalDeviceProperties
+     * @return properties of this physical device (ids, driver version, limits, ...)
+     */
+    const vk::PhysicalDeviceProperties& get_properties() const;
+
+    /**
+     * @see https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/chap36.html#features
+     * @return features supported by this physical device
+     */
+    const vk::PhysicalDeviceFeatures& get_features() const;
+
     /**
      * @see https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/chap36.html#_device_extensions
      * @return extensions supported by this physical device
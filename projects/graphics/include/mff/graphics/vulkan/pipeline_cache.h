@@ -0,0 +1,92 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <mff/leaf.h>
+#include <mff/graphics/vulkan/vulkan.h>
+
+namespace mff::vulkan {
+
+class Device;
+class PipelineCache;
+using UniquePipelineCache = std::unique_ptr<PipelineCache>;
+
+enum class pipeline_cache_error_code {
+    write_error
+};
+
+/**
+ * Cache of compiled pipelines which can be persisted to file (so the pipelines do not have to be
+ * compiled from SPIR-V on every launch).
+ *
+ * The data in file are prefixed by our own header with the identity of the device and driver
+ * (vendor, device, driver version and pipeline cache UUID) - when it does not match the current
+ * device (or the file is corrupted) the cache starts empty instead of trusting the driver to
+ * reject the data.
+ *
+ * @see https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/chap10.html#pipelines-cache
+ */
+class PipelineCache {
+public:
+    ~PipelineCache();
+
+    /**
+     * @return concrete vulkan PipelineCache
+     */
+    vk::PipelineCache get_handle() const;
+
+    /**
+     * @return was the cache initialized with valid data from file?
+     */
+    bool is_warm() const;
+
+    /**
+     * @return the file from which was the cache loaded (and to which it is saved)
+     */
+    const std::optional<std::string>& get_file_name() const;
+
+    /**
+     * Save the cache data (prefixed by device header) to the file from which was the cache loaded
+     * (no-op if the cache is not backed by file). Called automatically on destruction.
+     * @return
+     */
+    boost::leaf::result<void> save() const;
+
+    /**
+     * Build pipeline cache for the device
+     * @param device
+     * @param file_name file from which the cache is loaded (if it exists and is valid for the
+     *                  device) and to which it is saved
+     * @return
+     */
+    static boost::leaf::result<UniquePipelineCache> build(
+        const Device* device,
+        std::optional<std::string> file_name = std::nullopt
+    );
+
+private:
+    PipelineCache() = default;
+
+    /**
+     * Read the cache file and check whether it was created for this device
+     * @return the driver cache data (without our header) or std::nullopt if not valid
+     */
+    std::optional<std::vector<char>> load_file_data() const;
+
+    const Device* device_ = nullptr;
+    std::optional<std::string> file_name_ = std::nullopt;
+    bool warm_ = false;
+    vk::UniquePipelineCache handle_ = {};
+};
+
+}
+
+namespace boost::leaf {
+
+template <>
+struct is_e_type<mff::vulkan::pipeline_cache_error_code> : public std::true_type {};
+
+}
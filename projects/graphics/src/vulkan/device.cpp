@@ -14,7 +14,8 @@ namespace mff::vulkan {
 boost::leaf::result<std::tuple<UniqueDevice, std::vector<SharedQueue>>> Device::build(
     const PhysicalDevice* physical_device,
     const std::vector<const QueueFamily*>& queue_families,
-    const std::vector<std::string>& extensions
+    const std::vector<std::string>& extensions,
+    const vk::PhysicalDeviceFeatures& features
 ) {
     auto instance = physical_device->get_instance();
 
@@ -62,7 +63,8 @@ boost::leaf::result<std::tuple<UniqueDevice, std::vector<SharedQueue>>> Device::
         layers_c.size(),
         layers_c.data(),
         extensions_c.size(),
-        extensions_c.data());
+        extensions_c.data(),
+        &features);
 
     struct enable_Device : public Device {};
     std::unique_ptr<Device> device = std::make_unique<enable_Device>();
@@ -71,11 +73,14 @@ boost::leaf::result<std::tuple<UniqueDevice, std::vector<SharedQueue>>> Device::
     device->physical_device_ = physical_device;
     device->layers_ = layers;
     device->extensions_ = extensions;
+    device->features_ = features;
 
     LEAF_AUTO_TO(device->handle_, to_result(physical_device->get_handle().createDeviceUnique(device_create_info)));
 
     init_dispatcher(device->handle_.get());
 
+    LEAF_AUTO_TO(device->pipeline_cache_, PipelineCache::build(device.get()));
+
     std::vector<std::shared_ptr<Queue>> uniq_queues = uniq_families
         | ranges::views::transform(
             [&](const auto& queue_family) {
@@ -107,17 +112,22 @@ boost::leaf::result<std::tuple<UniqueDevice, std::vector<SharedQueue>>> Device::
     }
 
     LEAF_AUTO_TO(device->allocator_, ::vma::Allocator::build(device.get()));
+    // the pools outlive this function, so they can not capture the unique_ptr itself
+    auto device_ptr = device.get();
+
     device->semaphores_pool_ = std::make_unique<ObjectPool<mff::vulkan::Semaphore>>(
-        [&]() {
-            assert(false);
-            return mff::vulkan::Semaphore::build(device.get());
+        [device_ptr]() {
+            return mff::vulkan::Semaphore::build(device_ptr);
         }
     );
 
+    // fences are returned to the pool unsignaled
     device->fences_pool_ = std::make_unique<ObjectPool<mff::vulkan::Fence>>(
-        [&]() {
-            assert(false);
-            return mff::vulkan::Fence::build(device.get(), false);
+        [device_ptr]() {
+            return mff::vulkan::Fence::build(device_ptr, false);
+        },
+        [device_ptr](mff::vulkan::Fence* fence) {
+            device_ptr->get_handle().resetFences({fence->get_handle()});
         }
     );
 
@@ -136,10 +146,24 @@ const std::vector<std::string>& Device::get_extensions() const {
     return extensions_;
 }
 
+const vk::PhysicalDeviceFeatures& Device::get_enabled_features() const {
+    return features_;
+}
+
 vk::Device Device::get_handle() const {
     return handle_.get();
 }
 
+const PipelineCache* Device::get_pipeline_cache() const {
+    return pipeline_cache_.get();
+}
+
+boost::leaf::result<void> Device::load_pipeline_cache(const std::string& file_name) {
+    LEAF_AUTO_TO(pipeline_cache_, PipelineCache::build(this, file_name));
+
+    return {};
+}
+
 boost::leaf::result<CommandPool*> Device::get_command_pool(const QueueFamily* queue_family) {
     auto id = queue_family->get_index();
 
@@ -101,7 +101,7 @@ boost::leaf::result<std::unique_ptr<GraphicsPipeline>> GraphicsPipelineBuilder::
     result->device_ = device;
     result->pipeline_layout_ = std::move(layout);
     LEAF_AUTO_TO(result->pipeline_,
-                 to_result(device->get_handle().createGraphicsPipelineUnique(nullptr, pipeline_info)));
+                 to_result(device->get_handle().createGraphicsPipelineUnique(device->get_pipeline_cache()->get_handle(), pipeline_info)));
 
     return result;
 }
@@ -220,6 +220,14 @@ vk::PhysicalDeviceType PhysicalDevice::get_type() const {
     return properties_.deviceType;
 }
 
+const vk::PhysicalDeviceProperties& PhysicalDevice::get_properties() const {
+    return properties_;
+}
+
+const vk::PhysicalDeviceFeatures& PhysicalDevice::get_features() const {
+    return features_;
+}
+
 vk::PhysicalDevice PhysicalDevice::get_handle() const {
     return handle_;
 }
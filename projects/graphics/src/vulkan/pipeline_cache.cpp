@@ -0,0 +1,184 @@
+#include <mff/graphics/vulkan/pipeline_cache.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <mff/utils.h>
+#include <mff/graphics/logger.h>
+#include <mff/graphics/utils.h>
+#include <mff/graphics/vulkan/device.h>
+#include <mff/graphics/vulkan/instance.h>
+
+namespace mff::vulkan {
+
+namespace {
+
+const std::uint32_t kPIPELINE_CACHE_MAGIC = 0x4350464d; // "MFPC"
+const std::uint32_t kPIPELINE_CACHE_VERSION = 1;
+
+/**
+ * Header written before the driver cache data (identifies the device and driver which created it)
+ */
+struct PipelineCacheHeader {
+    std::uint32_t magic = kPIPELINE_CACHE_MAGIC;
+    std::uint32_t version = kPIPELINE_CACHE_VERSION;
+    std::uint32_t vendor_id = 0;
+    std::uint32_t device_id = 0;
+    std::uint32_t driver_version = 0;
+    std::uint8_t pipeline_cache_uuid[VK_UUID_SIZE] = {};
+    std::uint64_t data_size = 0;
+    std::uint64_t data_hash = 0;
+};
+
+/**
+ * FNV-1a hash of the cache data (to detect truncated or corrupted files)
+ * @param data
+ * @param size
+ * @return
+ */
+std::uint64_t hash_data(const void* data, std::size_t size) {
+    std::uint64_t hash = 0xcbf29ce484222325;
+    auto bytes = static_cast<const std::uint8_t*>(data);
+
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+/**
+ * Build the header identifying the physical device
+ * @param physical_device
+ * @return
+ */
+PipelineCacheHeader make_header(const PhysicalDevice* physical_device) {
+    const auto& properties = physical_device->get_properties();
+
+    PipelineCacheHeader header;
+    header.vendor_id = properties.vendorID;
+    header.device_id = properties.deviceID;
+    header.driver_version = properties.driverVersion;
+    std::memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    return header;
+}
+
+}
+
+boost::leaf::result<UniquePipelineCache> PipelineCache::build(
+    const Device* device,
+    std::optional<std::string> file_name
+) {
+    struct enable_PipelineCache : public PipelineCache {};
+    UniquePipelineCache result = std::make_unique<enable_PipelineCache>();
+
+    result->device_ = device;
+    result->file_name_ = std::move(file_name);
+
+    auto data = result->load_file_data();
+    result->warm_ = data.has_value() && !data->empty();
+
+    vk::PipelineCacheCreateInfo info(
+        {},
+        result->warm_ ? data->size() : 0,
+        result->warm_ ? data->data() : nullptr
+    );
+
+    LEAF_AUTO_TO(
+        result->handle_,
+        to_result(device->get_handle().createPipelineCacheUnique(info)));
+
+    return result;
+}
+
+PipelineCache::~PipelineCache() {
+    if (!handle_) return;
+
+    auto result = save();
+
+    if (!result) {
+        logger::vulkan->warn("Could not save pipeline cache to \"{}\"", file_name_.value_or(""));
+    }
+}
+
+std::optional<std::vector<char>> PipelineCache::load_file_data() const {
+    if (!file_name_ || !std::filesystem::exists(file_name_.value())) return std::nullopt;
+
+    auto bytes = mff::read_file(file_name_.value());
+
+    PipelineCacheHeader header;
+    auto expected = make_header(device_->get_physical_device());
+
+    if (bytes.size() < sizeof(header)) {
+        logger::vulkan->info("Pipeline cache \"{}\" is truncated, ignoring it", file_name_.value());
+        return std::nullopt;
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    bool same_device = header.magic == expected.magic
+        && header.version == expected.version
+        && header.vendor_id == expected.vendor_id
+        && header.device_id == expected.device_id
+        && header.driver_version == expected.driver_version
+        && std::memcmp(header.pipeline_cache_uuid, expected.pipeline_cache_uuid, VK_UUID_SIZE) == 0;
+
+    if (!same_device) {
+        logger::vulkan->info("Pipeline cache \"{}\" was created by other device or driver, ignoring it", file_name_.value());
+        return std::nullopt;
+    }
+
+    if (header.data_size != bytes.size() - sizeof(header)
+        || header.data_hash != hash_data(bytes.data() + sizeof(header), header.data_size)) {
+        logger::vulkan->info("Pipeline cache \"{}\" is corrupted, ignoring it", file_name_.value());
+        return std::nullopt;
+    }
+
+    return std::vector<char>(bytes.begin() + sizeof(header), bytes.end());
+}
+
+boost::leaf::result<void> PipelineCache::save() const {
+    if (!file_name_) return {};
+
+    LEAF_AUTO(data, to_result(device_->get_handle().getPipelineCacheData(handle_.get())));
+
+    auto header = make_header(device_->get_physical_device());
+    header.data_size = data.size();
+    header.data_hash = hash_data(data.data(), data.size());
+
+    // write to temporary file first, so the concurrently starting processes never see partial file
+    auto temporary_file_name = file_name_.value() + ".tmp";
+
+    {
+        std::ofstream file(temporary_file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+        if (!file) return LEAF_NEW_ERROR(pipeline_cache_error_code::write_error);
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_file_name, file_name_.value(), error);
+
+    if (error) return LEAF_NEW_ERROR(pipeline_cache_error_code::write_error);
+
+    return {};
+}
+
+vk::PipelineCache PipelineCache::get_handle() const {
+    return handle_.get();
+}
+
+bool PipelineCache::is_warm() const {
+    return warm_;
+}
+
+const std::optional<std::string>& PipelineCache::get_file_name() const {
+    return file_name_;
+}
+
+}
@@ -8,6 +8,7 @@ enum class ErrorKind {
     IsA,
     Alpha,
     Digit,
+    Float,
     Alt,
     Many0,
     Many1,
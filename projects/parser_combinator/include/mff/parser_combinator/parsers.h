@@ -6,6 +6,7 @@
 #include "./parsers/combinator.h"
 #include "./parsers/multi.h"
 #include "./parsers/sequence.h"
+#include "./rule.h"
 
 namespace mff::parser_combinator::parsers {
 
@@ -21,6 +22,7 @@ struct Parsers {
     static constexpr inline tuple_fn<Input, Error> tuple = {};
     static constexpr inline many0_fn<Input, Error> many0 = {};
     static constexpr inline many1_fn<Input, Error> many1 = {};
+    static constexpr inline fold_many0_fn<Input, Error> fold_many0 = {};
     static constexpr inline separated_list_fn<Input, Error> separated_list = {};
     static constexpr inline separated_nonempty_list_fn<Input, Error> separated_nonempty_list = {};
     static constexpr inline parsers::combinator::ignore_fn<Input, Error> ignore = {};
@@ -31,12 +33,36 @@ struct Parsers {
     static constexpr inline parsers::combinator::recognize_fn<Input, Error> recognize = {};
     static constexpr inline parsers::combinator::verify_fn<Input, Error> verify = {};
 
+    /**
+     * Type erased parser (for recursive grammars) - see parser_combinator::rule
+     */
+    template <typename Output>
+    using rule = parser_combinator::rule<Input, Output, Error>;
+
+    /**
+     * Check (at compile time) that the parser has the specified output and return it unchanged -
+     * names the type of intermediate parser without erasing it
+     * @tparam Output
+     * @param parser
+     * @return
+     */
+    template <typename Output, typename Parser>
+    static constexpr Parser typed(Parser parser) {
+        static_assert(
+            std::is_same_v<utils::parser_output_t<Parser, Input>, Output>,
+            "The output of parser is not of specified type"
+        );
+
+        return parser;
+    }
+
     struct complete {
         static constexpr inline parsers::complete::alpha0_fn<Input, Error> alpha0 = {};
         static constexpr inline parsers::complete::alpha1_fn<Input, Error> alpha1 = {};
         static constexpr inline parsers::complete::char_p_fn<Input, Error> char_p = {};
         static constexpr inline parsers::complete::digit0_fn<Input, Error> digit0 = {};
         static constexpr inline parsers::complete::digit1_fn<Input, Error> digit1 = {};
+        static constexpr inline parsers::complete::float_p_fn<Input, Error> float_p = {};
         static constexpr inline parsers::complete::is_a_fn<Input, Error> is_a = {};
         static constexpr inline parsers::complete::is_not_fn<Input, Error> is_not = {};
         static constexpr inline parsers::complete::tag_fn<Input, Error> tag = {};
@@ -2,4 +2,5 @@
 
 #include "./character/alpha.h"
 #include "./character/char.h"
-#include "./character/digit.h"
\ No newline at end of file
+#include "./character/digit.h"
+#include "./character/number.h"
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <charconv>
+#include <iterator>
+#include <memory>
+
+#include <mff/parser_combinator/traits/as_char.h>
+#include <mff/parser_combinator/traits/input_take.h>
+#include <mff/parser_combinator/traits/input_iterator.h>
+#include <mff/parser_combinator/parser_result.h>
+#include <mff/parser_combinator/error/default_error.h>
+#include <mff/parser_combinator/error/error_traits.h>
+#include <mff/parser_combinator/utils.h>
+
+namespace mff::parser_combinator::parsers::complete {
+
+/**
+ * Parses floating point number (optional sign, digits with optional decimal part or decimal part
+ * only and optional exponent) - "-1", "+.5", "1.", "2.5e-3". The exponent is consumed only when it
+ * is followed by digits ("1e" parses "1" and leaves "e").
+ *
+ * The number is converted directly from the input (std::from_chars), so the input has to be
+ * contiguous sequence of chars (std::string or std::string_view) - there are no allocations.
+ */
+template <
+    typename Input,
+    typename Error = error::DefaultError <Input>
+>
+struct float_p_fn {
+    ParserResult<Input, float, Error> operator()(
+        const Input& input
+    ) const {
+        using value_type = traits::iterator::value_type_t<Input>;
+
+        auto begin = traits::iterator::begin(input);
+        auto end = traits::iterator::end(input);
+        auto current = begin;
+
+        auto is_char = [&](char c) {
+            return current != end && traits::as_char::as_char<value_type>(*current) == c;
+        };
+        auto skip_digits = [&]() {
+            auto start = current;
+            while (current != end && traits::as_char::is_dec_digit<value_type>(*current)) current++;
+
+            return current != start;
+        };
+
+        auto number_begin = current;
+
+        // from_chars does not accept the plus sign (so it is skipped)
+        if (is_char('+')) {
+            number_begin = ++current;
+        } else if (is_char('-')) {
+            current++;
+        }
+
+        bool has_digits = skip_digits();
+
+        if (is_char('.')) {
+            current++;
+            has_digits = skip_digits() || has_digits;
+        }
+
+        if (!has_digits) {
+            return make_parser_result_error<Input, float, Error>(input, error::ErrorKind::Float);
+        }
+
+        if (is_char('e') || is_char('E')) {
+            auto mantissa_end = current;
+            current++;
+
+            if (is_char('+') || is_char('-')) current++;
+            if (!skip_digits()) current = mantissa_end;
+        }
+
+        float value = 0.0f;
+        auto[ptr, ec] = std::from_chars(
+            std::to_address(number_begin),
+            std::to_address(current),
+            value,
+            std::chars_format::general);
+
+        if (ec != std::errc()) {
+            return make_parser_result_error<Input, float, Error>(input, error::ErrorKind::Float);
+        }
+
+        auto length = std::distance(begin, current);
+
+        return make_parser_result<Input, float, Error>(
+            traits::input::slice(input, length, traits::iterator::length(input)),
+            std::move(value));
+    }
+};
+
+}
@@ -12,7 +12,7 @@ struct constant_fn {
     template <typename Value>
     auto operator()(Value val) const {
         return [val](const Input& input) -> ParserResult <Input, Value, Error> {
-            return make_parser_result(input, val);
+            return make_parser_result(input, Value(val));
         };
     }
 };
@@ -26,7 +26,7 @@ struct opt_fn {
                 return tl::make_unexpected(error);
             }
 
-            return make_parser_result<Input, Output, Error>(result->next_input, std::make_optional(result->output));
+            return make_parser_result<Input, Output, Error>(result->next_input, std::make_optional(std::move(result->output)));
         };
     }
 };
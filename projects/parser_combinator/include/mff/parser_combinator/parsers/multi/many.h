@@ -1,5 +1,6 @@
 #pragma once
 
+#include <type_traits>
 #include <vector>
 
 #include <mff/parser_combinator/parser_result.h>
@@ -99,4 +100,47 @@ struct many1_fn {
     }
 };
 
+/**
+ * applies the parser until it fails and folds the outputs into accumulator (no intermediate vector)
+ */
+template <typename Input, typename Error = error::DefaultError <Input>>
+struct fold_many0_fn {
+    /**
+     * @param parser
+     * @param init creates the initial value of accumulator
+     * @param fold called as fold(accumulator, output) for every parsed output
+     * @return
+     */
+    template <typename Parser, typename Init, typename Fold>
+    auto operator()(Parser parser, Init init, Fold fold) const {
+        using Output = std::invoke_result_t<Init>;
+
+        return [parser, init, fold](const Input& input) -> ParserResult <Input, Output, Error> {
+            Output result = init();
+            Input i(input);
+
+            while (true) {
+                auto parser_result = parser(i);
+
+                if (!parser_result) {
+                    auto error = parser_result.error();
+
+                    if (error.is_error()) {
+                        return make_parser_result<Input, Output, Error>(i, std::move(result));
+                    }
+
+                    return tl::make_unexpected(error);
+                }
+
+                if (i == parser_result->next_input) {
+                    return make_parser_result_error<Input, Output, Error>(i, error::ErrorKind::Many0);
+                }
+
+                fold(result, std::move(parser_result->output));
+                i = parser_result->next_input;
+            }
+        };
+    }
+};
+
 }
\ No newline at end of file
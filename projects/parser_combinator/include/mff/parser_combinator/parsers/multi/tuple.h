@@ -26,7 +26,7 @@ auto tuple_impl(Parser parser) {
         if (!result) return tl::make_unexpected(result.error());
 
         // if we got only one parser redirect the output
-        return make_parser_result(result->next_input, std::make_tuple(result->output));
+        return make_parser_result(result->next_input, std::make_tuple(std::move(result->output)));
     };
 }
 
@@ -48,7 +48,7 @@ auto tuple_impl(Parser parser, Others... others) {
 
         return make_parser_result(
             base_result->next_input,
-            std::tuple_cat(std::make_tuple(parser_result->output), base_result->output));
+            std::tuple_cat(std::make_tuple(std::move(parser_result->output)), std::move(base_result->output)));
     };
 }
 
@@ -26,8 +26,8 @@ struct separated_pair_fn {
             return make_parser_result<Input, Output, Error>(
                 second_result->next_input,
                 std::make_pair(
-                    first_result->output,
-                    second_result->output
+                    std::move(first_result->output),
+                    std::move(second_result->output)
                 )
             );
         };
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include <mff/parser_combinator/parser_result.h>
+#include <mff/parser_combinator/utils.h>
+
+namespace mff::parser_combinator {
+
+/**
+ * The only place where the type of the parser is erased (one indirect call per use). The parsers
+ * composed by combinators have their own (unnamed) types, so they should be kept in `auto`
+ * variables (or checked by `typed`) - the rule is needed only for recursive grammars (where the
+ * parser has to be used before it is defined) or when the parser has to cross translation units.
+ *
+ * The copies of rule share the definition, so the rule can be used in other parsers before it is
+ * defined. When the rule is used in its own definition use `ref()` instead of copy (the copy would
+ * create reference cycle and the definition would be never freed).
+ *
+ * @tparam Input
+ * @tparam Output
+ * @tparam Error
+ */
+template <typename Input, typename Output, typename Error = error::DefaultError<Input>>
+class rule {
+public:
+    using result_type = ParserResult<Input, Output, Error>;
+    using function_type = std::function<result_type(const Input&)>;
+
+    /**
+     * Declare the rule (it has to be defined before it is used for parsing)
+     */
+    rule() : definition_(std::make_shared<function_type>()) {}
+
+    /**
+     * Declare and define the rule
+     * @param parser
+     */
+    template <
+        typename Parser,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<Parser>, rule>>
+    >
+    rule(Parser&& parser) : rule() {
+        define(std::forward<Parser>(parser));
+    }
+
+    /**
+     * Define the rule (all the copies of this rule are using the new definition)
+     * @param parser
+     * @return
+     */
+    template <
+        typename Parser,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<Parser>, rule>>
+    >
+    rule& operator=(Parser&& parser) {
+        define(std::forward<Parser>(parser));
+
+        return *this;
+    }
+
+    /**
+     * Parse the input by the definition of the rule
+     * @param input
+     * @return
+     */
+    result_type operator()(const Input& input) const {
+        return (*definition_)(input);
+    }
+
+    /**
+     * Get non-owning parser referencing this rule (this rule has to outlive it)
+     * @return
+     */
+    auto ref() const {
+        const function_type* definition = definition_.get();
+
+        return [definition](const Input& input) -> result_type {
+            return (*definition)(input);
+        };
+    }
+
+private:
+    template <typename Parser>
+    void define(Parser&& parser) {
+        static_assert(
+            std::is_same_v<utils::parser_output_t<std::decay_t<Parser>, Input>, Output>,
+            "The output of parser has to be the same as the output of rule"
+        );
+
+        *definition_ = std::forward<Parser>(parser);
+    }
+
+    std::shared_ptr<function_type> definition_;
+};
+
+}
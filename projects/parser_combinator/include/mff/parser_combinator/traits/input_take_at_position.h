@@ -43,36 +43,22 @@ public:
 
     template <typename Error, typename P>
     ParserResult<T, T, Error> split_at_position_complete(const T& from, P predicate) {
-        auto result = split_at_position<Error, P>(from, predicate);
-        auto length = iterator::length(from);
-
-        if (result.has_value()) return *result;
-
-        auto error = result.error();
-
-        if (error.is_incomplete()) return input::take_length(from, length);
+        // at the end of complete input the whole input is taken (instead of incomplete error)
+        auto pos = iterator::position(from, predicate);
 
-        return tl::make_unexpected(error);
+        return input::take_length(from, pos == std::nullopt ? iterator::length(from) : *pos);
     }
 
     template <typename Error, typename P>
     ParserResult<T, T, Error> split_at_position1_complete(const T& from, P predicate, error::ErrorKind kind) {
-        auto result = split_at_position1<Error, P>(from, predicate, kind);
-        auto length = iterator::length(from);
-
-        if (result.has_value()) return *result;
-
-        auto error = result.error();
-
-        if (error.is_incomplete()) {
-            if (length == 0) {
-                return make_parser_result_error<T, T, Error>(from, kind);
-            }
+        auto pos = iterator::position(from, predicate);
+        auto length = pos == std::nullopt ? iterator::length(from) : *pos;
 
-            return input::take_length(from, length);
+        if (length == 0) {
+            return make_parser_result_error<T, T, Error>(from, kind);
         }
 
-        return tl::make_unexpected(error);
+        return input::take_length(from, length);
     }
 };
 
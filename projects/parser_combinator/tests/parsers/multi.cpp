@@ -52,6 +52,32 @@ SCENARIO("there exists a many parser") {
     }
 }
 
+SCENARIO("there exists a fold_many0 parser") {
+    GIVEN("a fold_many0 parser counting the length of \"abc\" tags") {
+        auto parser = parsers::fold_many0_fn<std::string>{}(
+            parsers::complete::tag_fn<std::string>{}("abc"s),
+            []() -> std::size_t { return 0; },
+            [](std::size_t& length, const std::string& tag) { length += tag.size(); }
+        );
+
+        WHEN("we try to parse \"abcabc123\"") {
+            auto result = parser("abcabc123");
+
+            THEN("it should succeed and return \"123\" as next input and 6 as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result("123"s, std::size_t(6)));
+            }
+        }
+
+        WHEN("we try to parse \"\"") {
+            auto result = parser("");
+
+            THEN("it should succeed and return the initial value as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(""s, std::size_t(0)));
+            }
+        }
+    }
+}
+
 SCENARIO("there exists a separated_list parser") {
     GIVEN("A separated list parser of string \"abc\" separated by \"|\"") {
         auto parser = parsers::separated_list_fn<std::string>{}(
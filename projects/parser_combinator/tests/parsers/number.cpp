@@ -0,0 +1,171 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <mff/parser_combinator/parsers.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+namespace parsers = mff::parser_combinator::parsers;
+namespace error = mff::parser_combinator::error;
+
+SCENARIO("there exists a float parser") {
+    using P = parsers::Parsers<std::string_view>;
+
+    GIVEN("float_p parser") {
+        WHEN("we try to parse \"12.5,3\"") {
+            auto result = P::complete::float_p("12.5,3"sv);
+
+            THEN("it should return 12.5 as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(",3"sv, 12.5f));
+            }
+        }
+
+        WHEN("we try to parse numbers with signs and without integer or decimal part") {
+            THEN("it should parse them") {
+                REQUIRE(P::complete::float_p("-5"sv) == mff::parser_combinator::make_parser_result(""sv, -5.0f));
+                REQUIRE(P::complete::float_p("+.5"sv) == mff::parser_combinator::make_parser_result(""sv, 0.5f));
+                REQUIRE(P::complete::float_p("1."sv) == mff::parser_combinator::make_parser_result(""sv, 1.0f));
+                REQUIRE(P::complete::float_p("-.25-1"sv) == mff::parser_combinator::make_parser_result("-1"sv, -0.25f));
+            }
+        }
+
+        WHEN("we try to parse numbers following each other (\"0.5.5\")") {
+            auto result = P::complete::float_p("0.5.5"sv);
+
+            THEN("it should stop at the second dot") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(".5"sv, 0.5f));
+            }
+        }
+
+        WHEN("we try to parse numbers with exponent") {
+            THEN("it should parse the exponent only if it is followed by digits") {
+                REQUIRE(P::complete::float_p("2.5e-3z"sv) == mff::parser_combinator::make_parser_result("z"sv, 2.5e-3f));
+                REQUIRE(P::complete::float_p("1E2"sv) == mff::parser_combinator::make_parser_result(""sv, 100.0f));
+                REQUIRE(P::complete::float_p("1em"sv) == mff::parser_combinator::make_parser_result("em"sv, 1.0f));
+                REQUIRE(P::complete::float_p("1e+"sv) == mff::parser_combinator::make_parser_result("e+"sv, 1.0f));
+            }
+        }
+
+        WHEN("we try to parse something which is not a number") {
+            THEN("it should fail") {
+                REQUIRE(P::complete::float_p("."sv) == mff::parser_combinator::make_parser_result_error<std::string_view, float>(
+                    "."sv,
+                    error::ErrorKind::Float
+                ));
+                REQUIRE(P::complete::float_p("+-1"sv) == mff::parser_combinator::make_parser_result_error<std::string_view, float>(
+                    "+-1"sv,
+                    error::ErrorKind::Float
+                ));
+                REQUIRE(P::complete::float_p(""sv) == mff::parser_combinator::make_parser_result_error<std::string_view, float>(
+                    ""sv,
+                    error::ErrorKind::Float
+                ));
+            }
+        }
+
+        WHEN("we try to parse number out of float range (\"1e50\")") {
+            auto result = P::complete::float_p("1e50"sv);
+
+            THEN("it should fail") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result_error<std::string_view, float>(
+                    "1e50"sv,
+                    error::ErrorKind::Float
+                ));
+            }
+        }
+
+        WHEN("we try to parse std::string \"-7.75abc\"") {
+            auto result = parsers::complete::float_p_fn<std::string>{}("-7.75abc"s);
+
+            THEN("it should return -7.75 as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result("abc"s, -7.75f));
+            }
+        }
+    }
+}
+
+#ifdef MFF_PARSER_COMBINATOR_TIGER_SVG
+
+/**
+ * Get all the numbers in the path data ("d" attributes) of SVG file
+ */
+std::vector<std::string_view> get_path_data(std::string_view svg) {
+    std::vector<std::string_view> result;
+    std::size_t position = 0;
+
+    while ((position = svg.find(" d=\"", position)) != std::string_view::npos) {
+        position += 4;
+        auto end = svg.find('"', position);
+
+        result.push_back(svg.substr(position, end - position));
+        position = end;
+    }
+
+    return result;
+}
+
+/**
+ * Parse all the numbers in path data (skipping the commands and separators) by the number parser
+ */
+template <typename NumberParser>
+float sum_path_numbers(const std::vector<std::string_view>& data, const NumberParser& parse_number) {
+    float sum = 0.0f;
+
+    for (auto input: data) {
+        while (!input.empty()) {
+            auto result = parse_number(input);
+
+            if (result) {
+                sum += result->output;
+                input = result->next_input;
+            } else {
+                input.remove_prefix(1);
+            }
+        }
+    }
+
+    return sum;
+}
+
+TEST_CASE("float parser benchmark (path data of Ghostscript tiger)", "[.benchmark]") {
+    using P = parsers::Parsers<std::string_view>;
+
+    std::ifstream file(MFF_PARSER_COMBINATOR_TIGER_SVG);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    auto svg = buffer.str();
+    auto data = get_path_data(svg);
+
+    REQUIRE(!data.empty());
+
+    // the previous way - recognize the number and convert it through temporary string
+    auto parse_recognized = P::map(
+        P::recognize(
+            P::tuple(
+                P::opt(P::alt(P::complete::char_p('+'), P::complete::char_p('-'))),
+                P::alt(
+                    P::ignore(P::tuple(P::complete::digit1, P::opt(P::pair(P::complete::char_p('.'), P::opt(P::complete::digit1))))),
+                    P::ignore(P::tuple(P::complete::char_p('.'), P::complete::digit1))
+                )
+            )),
+        [](std::string_view number) { return std::stof(std::string(number)); }
+    );
+
+    REQUIRE(sum_path_numbers(data, parse_recognized) == Approx(sum_path_numbers(data, P::complete::float_p)));
+
+    BENCHMARK("recognize and std::stof") {
+        return sum_path_numbers(data, parse_recognized);
+    };
+
+    BENCHMARK("float_p") {
+        return sum_path_numbers(data, P::complete::float_p);
+    };
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <mff/parser_combinator/parsers.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+namespace parsers = mff::parser_combinator::parsers;
+namespace error = mff::parser_combinator::error;
+
+SCENARIO("there exists rule (type erased parser)") {
+    using P = parsers::Parsers<std::string_view>;
+
+    GIVEN("rule defined by digit parser") {
+        P::rule<std::string_view> parser = P::complete::digit1;
+
+        WHEN("we try to parse \"123abc\"") {
+            auto result = parser("123abc"sv);
+
+            THEN("it should return \"123\" as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result("abc"sv, "123"sv));
+            }
+        }
+
+        WHEN("we try to parse \"abc\"") {
+            auto result = parser("abc"sv);
+
+            THEN("it should fail") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result_error<std::string_view, std::string_view>(
+                    "abc"sv,
+                    error::ErrorKind::Digit
+                ));
+            }
+        }
+    }
+
+    GIVEN("rule used before it is defined") {
+        P::rule<std::string_view> word;
+        auto words = P::many1(P::terminated(word, P::opt(P::complete::char_p(' '))));
+
+        word = P::complete::alpha1;
+
+        WHEN("we try to parse \"ab cd;\"") {
+            auto result = words("ab cd;"sv);
+
+            THEN("it should use the later definition") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(
+                    ";"sv,
+                    std::vector<std::string_view>{"ab"sv, "cd"sv}));
+            }
+        }
+    }
+
+    GIVEN("recursive rule (nested parentheses)") {
+        // depth ::= '(' depth ')' | ''
+        P::rule<std::size_t> depth;
+
+        depth = P::alt(
+            P::map(
+                P::delimited(P::complete::char_p('('), depth.ref(), P::complete::char_p(')')),
+                [](std::size_t inner) -> std::size_t { return inner + 1; }
+            ),
+            P::constant(std::size_t(0))
+        );
+
+        WHEN("we try to parse \"((()));\"") {
+            auto result = depth("((()));"sv);
+
+            THEN("it should return 3 as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(";"sv, std::size_t(3)));
+            }
+        }
+
+        WHEN("we try to parse \"(();\"") {
+            auto result = depth("(();"sv);
+
+            THEN("it should stop before the unbalanced parenthesis") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result("(();"sv, std::size_t(0)));
+            }
+        }
+    }
+}
+
+SCENARIO("there exists typed helper") {
+    using P = parsers::Parsers<std::string_view>;
+
+    GIVEN("typed digit parser") {
+        auto parser = P::typed<std::string_view>(P::complete::digit1);
+
+        THEN("it should keep the type of the parser") {
+            STATIC_REQUIRE(std::is_same_v<decltype(parser), std::decay_t<decltype(P::complete::digit1)>>);
+        }
+
+        WHEN("we try to parse \"12a\"") {
+            auto result = parser("12a"sv);
+
+            THEN("it should return \"12\" as output") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result("a"sv, "12"sv));
+            }
+        }
+    }
+}
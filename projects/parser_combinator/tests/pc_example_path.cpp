@@ -0,0 +1,239 @@
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <mff/parser_combinator/parsers.h>
+
+// Example of SVG path data grammar (subset: commands followed by numbers) - compares the statically
+// composed parser with the same grammar erased by rule and with hand-written scanner
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+namespace parsers = mff::parser_combinator::parsers;
+
+using P = parsers::Parsers<std::string_view>;
+
+// command with all of its arguments
+using PathCommand = std::pair<char, std::vector<float>>;
+
+bool is_path_space(char c) {
+    return c == 0x20 || c == 0x9 || c == 0xA || c == 0xD || c == 0xC;
+}
+
+bool is_path_command(char c) {
+    return c == 'M' || c == 'm' || c == 'L' || c == 'l' || c == 'C' || c == 'c' || c == 'Z' || c == 'z';
+}
+
+float to_float(std::string_view number) {
+    float result = 0.0f;
+    std::from_chars(number.data(), number.data() + number.size(), result);
+
+    return result;
+}
+
+/**
+ * Build the path data parser - all the intermediate parsers keep their own types
+ */
+auto build_static_path_parser() {
+    auto parse_space_optional = P::ignore(P::complete::take_while(is_path_space));
+    auto parse_separator = P::ignore(
+        P::tuple(parse_space_optional, P::opt(P::complete::char_p(',')), parse_space_optional));
+
+    auto parse_number = P::typed<float>(P::complete::float_p);
+
+    auto parse_command_char = P::map(
+        P::verify(P::complete::take(1), [](std::string_view c) { return is_path_command(c[0]); }),
+        [](std::string_view c) { return c[0]; }
+    );
+
+    auto parse_command = P::typed<PathCommand>(P::map(
+        P::pair(
+            P::preceded(parse_space_optional, parse_command_char),
+            P::many0(P::preceded(parse_separator, parse_number))
+        ),
+        [](auto command) -> PathCommand { return {command.first, std::move(command.second)}; }
+    ));
+
+    return P::terminated(P::many0(parse_command), parse_space_optional);
+}
+
+/**
+ * Build the same parser, but every intermediate parser is type erased by rule
+ */
+P::rule<std::vector<PathCommand>> build_erased_path_parser() {
+    P::rule<parsers::combinator::Ignore> parse_space_optional = P::ignore(P::complete::take_while(is_path_space));
+    P::rule<parsers::combinator::Ignore> parse_separator = P::ignore(
+        P::tuple(parse_space_optional, P::opt(P::complete::char_p(',')), parse_space_optional));
+
+    P::rule<float> parse_number = P::complete::float_p;
+
+    P::rule<char> parse_command_char = P::map(
+        P::verify(P::complete::take(1), [](std::string_view c) { return is_path_command(c[0]); }),
+        [](std::string_view c) { return c[0]; }
+    );
+
+    P::rule<PathCommand> parse_command = P::map(
+        P::pair(
+            P::preceded(parse_space_optional, parse_command_char),
+            P::many0(P::preceded(parse_separator, parse_number))
+        ),
+        [](auto command) -> PathCommand { return {command.first, std::move(command.second)}; }
+    );
+
+    return P::terminated(P::many0(parse_command), parse_space_optional);
+}
+
+/**
+ * Hand-written scanner of the same grammar
+ */
+std::vector<PathCommand> scan_path(std::string_view input) {
+    std::vector<PathCommand> result;
+    std::size_t i = 0;
+
+    auto skip_space = [&]() {
+        while (i < input.size() && is_path_space(input[i])) i++;
+    };
+
+    auto scan_number = [&](float& number) -> bool {
+        auto start = i;
+        std::size_t j = i;
+
+        if (j < input.size() && (input[j] == '+' || input[j] == '-')) j++;
+
+        auto digits_start = j;
+        while (j < input.size() && std::isdigit(input[j])) j++;
+        bool has_digits = j > digits_start;
+
+        if (j < input.size() && input[j] == '.') {
+            auto fraction_start = ++j;
+            while (j < input.size() && std::isdigit(input[j])) j++;
+
+            if (!has_digits && j == fraction_start) return false;
+        } else if (!has_digits) {
+            return false;
+        }
+
+        number = to_float(input.substr(start, j - start));
+        i = j;
+
+        return true;
+    };
+
+    while (true) {
+        skip_space();
+        if (i >= input.size() || !is_path_command(input[i])) break;
+
+        PathCommand command{input[i++], {}};
+
+        while (true) {
+            auto before = i;
+            skip_space();
+            if (i < input.size() && input[i] == ',') i++;
+            skip_space();
+
+            float number;
+            if (!scan_number(number)) {
+                i = before;
+                break;
+            }
+
+            command.second.push_back(number);
+        }
+
+        result.push_back(std::move(command));
+    }
+
+    return result;
+}
+
+/**
+ * Generate path data with many curves
+ */
+std::string generate_path_data(std::size_t commands_count) {
+    std::string result = "M 10,20";
+
+    for (std::size_t i = 0; i < commands_count; i++) {
+        auto n = std::to_string(i % 100);
+
+        result += " c -" + n + ".5," + n + " 3.25-1 ." + n + "," + n + ".125 12 " + n;
+        result += " L" + n + " " + n + ".75";
+    }
+
+    return result + " z";
+}
+
+SCENARIO("path data grammar example") {
+    static const auto parse_static = build_static_path_parser();
+    static const auto parse_erased = build_erased_path_parser();
+
+    GIVEN("simple path data") {
+        auto input = "M 10,20 l-5.5.5 C1 2 3,4 , 5 6 z"sv;
+        std::vector<PathCommand> expected = {
+            {'M', {10.0f, 20.0f}},
+            {'l', {-5.5f, 0.5f}},
+            {'C', {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}},
+            {'z', {}}
+        };
+
+        WHEN("we parse it by statically composed parser") {
+            auto result = parse_static(input);
+
+            THEN("it should return the commands") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(""sv, std::move(expected)));
+            }
+        }
+
+        WHEN("we parse it by type erased parser") {
+            auto result = parse_erased(input);
+
+            THEN("it should return the commands") {
+                REQUIRE(result == mff::parser_combinator::make_parser_result(""sv, std::move(expected)));
+            }
+        }
+
+        WHEN("we scan it by hand-written scanner") {
+            auto result = scan_path(input);
+
+            THEN("it should return the commands") {
+                REQUIRE(result == expected);
+            }
+        }
+    }
+
+    GIVEN("generated path data") {
+        auto data = generate_path_data(100);
+
+        THEN("all the parsers should return the same commands") {
+            auto expected = scan_path(data);
+
+            REQUIRE(expected.size() == 202);
+            REQUIRE(parse_static(data)->output == expected);
+            REQUIRE(parse_erased(data)->output == expected);
+        }
+    }
+}
+
+TEST_CASE("path data grammar benchmark", "[.benchmark]") {
+    static const auto parse_static = build_static_path_parser();
+    static const auto parse_erased = build_erased_path_parser();
+
+    auto data = generate_path_data(10000);
+    std::string_view input = data;
+
+    BENCHMARK("hand-written scanner") {
+        return scan_path(input);
+    };
+
+    BENCHMARK("statically composed parser") {
+        return parse_static(input);
+    };
+
+    BENCHMARK("type erased parser") {
+        return parse_erased(input);
+    };
+}
@@ -1,22 +1,7 @@
 #include "./canvas.h"
 
-namespace mapbox::util {
-
-// helpers for mathbox
-template <>
-struct nth<0, ::mff::Vector2f> {
-    inline static auto get(const ::mff::Vector2f& t) {
-        return t[0];
-    };
-};
-template <>
-struct nth<1, ::mff::Vector2f> {
-    inline static auto get(const ::mff::Vector2f& t) {
-        return t[1];
-    };
-};
-
-}
+#include "./scene_geometry.h"
+#include "./tessellation.h"
 
 namespace canvas {
 
@@ -24,80 +9,238 @@ Canvas::Canvas(Renderer* renderer)
     : renderer_(renderer) {
 }
 
-void Canvas::fill(canvas::Path2D& path, const Canvas::FillInfo& info) {
+void Canvas::fill(const canvas::Path2D& path, const Canvas::FillInfo& info) {
     auto prerendered = prerenderFill(path, info);
     drawPrerendered(prerendered);
 }
 
 
-void Canvas::stroke(canvas::Path2D& path, const Canvas::StrokeInfo& info) {
+void Canvas::stroke(const canvas::Path2D& path, const Canvas::StrokeInfo& info) {
     auto prerendered = prerenderStroke(path, info);
     drawPrerendered(prerendered);
 }
 
-Canvas::PrerenderedPath::Record::Record(
-    std::vector<Vertex> vertices,
-    std::vector<std::uint32_t> indices,
-    PushConstants constants
-)
-    : vertices(std::move(vertices))
-    , indices(std::move(indices))
-    , constants(std::move(constants)) {
+Canvas::PrerenderedPath::PrerenderedPath(const allocator_type& allocator)
+    : vertices(allocator), indices(allocator), records(allocator) {
 }
 
-Canvas::PrerenderedPath Canvas::prerenderFill(canvas::Path2D& path, const Canvas::FillInfo& info) {
-    PrerenderedPath result = {};
+void Canvas::PrerenderedPath::add(
+    const std::vector<mff::Vector2f>& record_vertices,
+    const std::vector<std::uint32_t>& record_indices,
+    PushConstants constants,
+    PipelineKind pipeline
+) {
+    records.push_back(
+        Record{
+            DrawRange{
+                static_cast<std::uint32_t>(indices.size()),
+                static_cast<std::uint32_t>(record_indices.size()),
+                static_cast<std::int32_t>(vertices.size())
+            },
+            constants,
+            pipeline
+        });
+
+    vertices.reserve(vertices.size() + record_vertices.size());
+    for (const auto& pos: record_vertices) vertices.push_back(Vertex{pos});
+    indices.insert(std::end(indices), std::begin(record_indices), std::end(record_indices));
+}
 
-    // get all the contours (simple paths)
-    auto cs = path.get_outline().get_contours();
+void Canvas::PrerenderedPath::add_written(
+    std::size_t first_vertex,
+    std::size_t first_index,
+    PushConstants constants,
+    PipelineKind pipeline
+) {
+    records.push_back(
+        Record{
+            DrawRange{
+                static_cast<std::uint32_t>(first_index),
+                static_cast<std::uint32_t>(indices.size() - first_index),
+                static_cast<std::int32_t>(first_vertex)
+            },
+            constants,
+            pipeline
+        });
+}
 
-    for (const auto& contour: cs) {
-        // flatten them and run them through triangulation algorithm
-        auto flattened = contour.flatten();
-        auto indices = ::mapbox::earcut<std::uint32_t>(std::vector<std::vector<mff::Vector2f>>{flattened});
-        auto vertices = flattened
-            | ranges::views::transform([](const auto& pos) { return Vertex{pos}; })
-            | ranges::to<std::vector>();
-
-        result.records
-            .emplace_back(
-                std::move(vertices),
-                std::move(indices),
-                PushConstants{info.color, info.transform.transform, info.transform.translation}
-            );
+Canvas::PrerenderedPath Canvas::prerenderFill(
+    const canvas::Path2D& path,
+    const Canvas::FillInfo& info,
+    const PrerenderedPath::allocator_type& allocator
+) {
+    if (info.mode == FillMode::StencilThenCover) {
+        return prerenderStencilFill(path, info, allocator);
     }
 
-    return std::move(result);
+    return prerenderTriangulatedFill(path, info, allocator);
 }
 
-void Canvas::drawPrerendered(const Canvas::PrerenderedPath& prerendered) {
-    for (const auto& item: prerendered.records) {
-        renderer_->draw(item.vertices, item.indices, item.constants);
+Canvas::PrerenderedPath Canvas::prerenderStencilFill(
+    const canvas::Path2D& path,
+    const Canvas::FillInfo& info,
+    const PrerenderedPath::allocator_type& allocator
+) {
+    PrerenderedPath result(allocator);
+
+    mff::Vector2f min = mff::Vector2f::Constant(std::numeric_limits<std::float_t>::max());
+    mff::Vector2f max = mff::Vector2f::Constant(std::numeric_limits<std::float_t>::lowest());
+
+    const auto& outline = path.get_outline();
+
+    // all the contours share one pivot (the first vertex) - the triangles from pivot to every
+    // edge count the winding number of every point in stencil
+    for (const auto& contour: outline.get_contours()) {
+        // the points are written directly to the final vertices (no intermediate vectors)
+        auto base = static_cast<std::uint32_t>(result.vertices.size());
+        contour.flatten_into(
+            [&](const mff::Vector2f& point) { result.vertices.push_back(Vertex{point}); },
+            info.flatten);
+
+        auto count = static_cast<std::uint32_t>(result.vertices.size()) - base;
+
+        if (count < 2) {
+            result.vertices.resize(base);
+            continue;
+        }
+
+        for (std::uint32_t i = 0; i < count; i++) {
+            // the fill always closes the contour
+            result.indices.insert(std::end(result.indices), {0, base + i, base + (i + 1) % count});
+
+            min = min.cwiseMin(result.vertices[base + i].pos);
+            max = max.cwiseMax(result.vertices[base + i].pos);
+        }
     }
+
+    if (result.vertices.empty()) return result;
+
+    PushConstants constants{info.color, info.transform.transform, info.transform.translation};
+
+    result.add_written(
+        0,
+        0,
+        constants,
+        info.fill_rule == FillRule::EvenOdd ? PipelineKind::StencilEvenOdd : PipelineKind::StencilNonZero);
+    result.add(
+        {min, mff::Vector2f(max[0], min[1]), max, mff::Vector2f(min[0], max[1])},
+        {0, 1, 2, 0, 2, 3},
+        constants,
+        PipelineKind::Cover);
+
+    return result;
 }
 
-Canvas::PrerenderedPath Canvas::prerenderStroke(canvas::Path2D& path, const Canvas::StrokeInfo& info) {
-    PrerenderedPath result = {};
+Canvas::PrerenderedPath Canvas::prerenderTriangulatedFill(
+    const canvas::Path2D& path,
+    const Canvas::FillInfo& info,
+    const PrerenderedPath::allocator_type& allocator
+) {
+    PrerenderedPath result(allocator);
+
+    // flatten all the contours (the fill always closes them)
+    std::vector<mff::Vector2f> points = {};
+    std::vector<std::size_t> contour_sizes = {};
+
+    for (const auto& contour: path.get_outline().get_contours()) {
+        auto first = points.size();
+        contour.flatten_into([&](const mff::Vector2f& point) { points.push_back(point); }, info.flatten);
+
+        contour_sizes.push_back(points.size() - first);
+    }
+
+    PushConstants constants{info.color, info.transform.transform, info.transform.translation};
+
+    // and triangulate them at once (so the holes are respected) to one record - earcut needs the
+    // contours which do not intersect or touch (their nesting decides the holes)
+    if (points.size() >= info.sweep_threshold || contours_intersect(points, contour_sizes)) {
+        auto tessellation = tessellate_fill(points, contour_sizes, info.fill_rule);
+
+        if (!tessellation.indices.empty()) result.add(tessellation.vertices, tessellation.indices, constants);
+
+        return result;
+    }
+
+    auto indices = triangulate_fill(points, contour_sizes, info.fill_rule);
 
+    if (!indices.empty()) result.add(points, indices, constants);
+
+    return result;
+}
+
+void Canvas::drawPrerendered(const Canvas::PrerenderedPath& prerendered) {
+    renderer_->draw(prerendered.vertices, prerendered.indices, prerendered.records);
+}
+
+boost::leaf::result<Canvas::UploadedPath> Canvas::upload(const Canvas::PrerenderedPath& prerendered) {
+    LEAF_AUTO(geometry, renderer_->upload(prerendered.vertices, prerendered.indices));
+
+    return UploadedPath{geometry, {std::begin(prerendered.records), std::end(prerendered.records)}};
+}
+
+void Canvas::release(const Canvas::UploadedPath& uploaded) {
+    renderer_->release(uploaded.geometry);
+}
+
+void Canvas::drawUploaded(const Canvas::UploadedPath& uploaded) {
+    renderer_->draw(uploaded.geometry, uploaded.records);
+}
+
+boost::leaf::result<void> Canvas::drawScene(const SceneGeometry& scene) {
+    auto geometry = scene.get_geometry();
+
+    // the scene has to be uploaded first
+    if (!geometry) return LEAF_NEW_ERROR();
+
+    return renderer_->draw(geometry.value(), scene.get_records());
+}
+
+Canvas::PrerenderedPath Canvas::prerenderStroke(
+    const canvas::Path2D& path,
+    const Canvas::StrokeInfo& info,
+    const PrerenderedPath::allocator_type& allocator
+) {
     // get all the contours (simple paths)
-    auto cs = path.get_outline().get_contours();
+    const auto& outline = path.get_outline();
+    const auto& cs = outline.get_contours();
+
+    if (info.mode == StrokeMode::Outline) {
+        // the outline of stroke is a shape which overlaps itself (at joins), so it is filled by
+        // nonzero fill rule
+        Outline stroked(allocator);
+
+        for (const auto& contour: cs) {
+            for (auto& stroke_contour: canvas::stroke(contour, info.style, info.flatten)) {
+                stroked.add_contour(std::move(stroke_contour));
+            }
+        }
+
+        return prerenderStencilFill(
+            Path2D(std::move(stroked)),
+            FillInfo{info.color, info.transform, FillRule::NonZero, FillMode::StencilThenCover, info.flatten},
+            allocator);
+    }
+
+    PrerenderedPath result(allocator);
+    std::vector<mff::Vector2f> flattened = {};
+    // the strokes of all contours are one record (the strips are separated by restart index)
+    StrokeResult stroked = {};
 
     for (const auto& contour: cs) {
-        // flatten them
-        auto flattened = contour.flatten();
-        // TODO: we should be able to stroke the contours directly not the flattened path
+        // flatten them (to the reused buffer)
+        flattened.clear();
+        contour.flatten_into([&](const mff::Vector2f& point) { flattened.push_back(point); }, info.flatten);
         // and then stroke the flattened path
-        auto points = get_stroke(flattened, info.style, contour.closed);
-        auto vertices = points.vertices
-            | ranges::views::transform([](const auto& pos) { return Vertex{pos}; })
-            | ranges::to<std::vector>();
-
-        result.records
-            .emplace_back(
-                std::move(vertices),
-                std::move(points.indices),
-                PushConstants{info.color, info.transform.transform, info.transform.translation}
-            );
+        append_stroke(stroked, flattened, info.style, contour.closed, info.flatten, info.topology);
+    }
+
+    if (!stroked.indices.empty()) {
+        result.add(
+            stroked.vertices,
+            stroked.indices,
+            PushConstants{info.color, info.transform.transform, info.transform.translation},
+            info.topology == StrokeTopology::TriangleStrip ? PipelineKind::OverStrip : PipelineKind::Over
+        );
     }
 
     return result;
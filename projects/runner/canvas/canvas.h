@@ -1,14 +1,17 @@
 #pragma once
 
+#include <memory_resource>
+
 #include <range/v3/all.hpp>
 
 #include "./path.h"
-#include "../third_party/earcut.hpp"
 #include "../renderer/renderer.h"
 #include "./stroke.h"
 
 namespace canvas {
 
+class SceneGeometry;
+
 /**
  * This class provides us with helper functions to render Path2D objects (which represents vector
  * graphics primitives)
@@ -17,12 +20,35 @@ class Canvas {
 public:
     Canvas(Renderer* renderer);
 
+    /**
+     * How is the fill of the shape going to be rendered
+     */
+    enum class FillMode {
+        // triangulate the path on CPU - small paths by earcut (the contours are grouped by the
+        // fill rule to polygons with holes), large ones and the ones whose contours intersect or
+        // touch by sweep line (see FillInfo::sweep_threshold)
+        Triangulate,
+        // count the coverage of triangle fan in stencil and then cover the bounding box of the
+        // path where the stencil was set (no triangulation, respects fill rule and holes)
+        StencilThenCover
+    };
+
     /**
      * Information how to fill the shape
      */
     struct FillInfo {
         mff::Vector4f color = mff::Vector4f::Ones();
         Transform2f transform = Transform2f::identity();
+        FillRule fill_rule = FillRule::NonZero;
+        // the triangulated fills of a scene are drawn by a few batches, while every stencil-then-cover
+        // fill needs its own stencil and cover draws
+        FillMode mode = FillMode::Triangulate;
+        // the tolerance should be in screen space (see FlattenOptions::transform)
+        FlattenOptions flatten = {};
+        // the flattened paths with at least this many points are tessellated by sweep line (earcut
+        // is faster below a few thousand points, but it slows down on large ones), the smaller ones
+        // only if their contours intersect - only for FillMode::Triangulate
+        std::size_t sweep_threshold = 4096;
     };
 
     /**
@@ -30,12 +56,28 @@ public:
      * @param path
      * @param info
      */
-    void fill(canvas::Path2D& path, const FillInfo& info);
+    void fill(const canvas::Path2D& path, const FillInfo& info);
+
+    /**
+     * How is the stroke of the shape going to be rendered
+     */
+    enum class StrokeMode {
+        // offset the curves to get the outline of the stroke (with exact round joins and caps) and
+        // fill it through stencil (nonzero)
+        Outline,
+        // flatten the contours and triangulate the stroke of polyline on CPU
+        Triangulate
+    };
 
     struct StrokeInfo {
         mff::Vector4f color = mff::Vector4f::Ones();
         StrokeStyle style = {};
         Transform2f transform = Transform2f::identity();
+        // the tolerance should be in screen space (see FlattenOptions::transform)
+        FlattenOptions flatten = {};
+        StrokeMode mode = StrokeMode::Triangulate;
+        // how are the triangles of stroke described (only for StrokeMode::Triangulate)
+        StrokeTopology topology = StrokeTopology::TriangleStrip;
     };
 
     /**
@@ -43,46 +85,155 @@ public:
      * @param path
      * @param info
      */
-    void stroke(canvas::Path2D& path, const StrokeInfo& info);
+    void stroke(const canvas::Path2D& path, const StrokeInfo& info);
 
     /**
-     * Path consists of multiple records (multiple contours / closed paths)
+     * Path consists of multiple records (multiple contours / closed paths) - all of them share
+     * the same vertices and indices and each record is just range in them
      */
     struct PrerenderedPath {
-        struct Record {
-            std::vector<Vertex> vertices = {};
-            std::vector<std::uint32_t> indices = {};
-            PushConstants constants = {};
-
-            Record(std::vector<Vertex> vertices, std::vector<std::uint32_t> indices, PushConstants constants);
-        };
-
-        std::vector<Record> records = {};
+        using Record = DrawRecord;
+        // the geometry is allocated by this allocator (so it can be allocated in arena)
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::pmr::vector<Vertex> vertices = {};
+        std::pmr::vector<std::uint32_t> indices = {};
+        std::pmr::vector<Record> records = {};
+
+        PrerenderedPath() = default;
+
+        /**
+         * Create empty path which allocates its geometry by the allocator
+         * @param allocator
+         */
+        explicit PrerenderedPath(const allocator_type& allocator);
+
+        /**
+         * Append new record (indices are relative to the first of the provided vertices)
+         * @param record_vertices
+         * @param record_indices
+         * @param constants
+         * @param pipeline
+         */
+        void add(
+            const std::vector<mff::Vector2f>& record_vertices,
+            const std::vector<std::uint32_t>& record_indices,
+            PushConstants constants,
+            PipelineKind pipeline = PipelineKind::Over
+        );
+
+        /**
+         * Append new record from the vertices and indices which were already written directly to
+         * the end of vertices and indices (indices are relative to first_vertex)
+         * @param first_vertex the first vertex of the record
+         * @param first_index the first index of the record
+         * @param constants
+         * @param pipeline
+         */
+        void add_written(
+            std::size_t first_vertex,
+            std::size_t first_index,
+            PushConstants constants,
+            PipelineKind pipeline = PipelineKind::Over
+        );
     };
 
     /**
      * Prerender stroke of path (to be reused)
      * @param path
      * @param info
+     * @param allocator the allocator of the prerendered geometry
      * @return
      */
-    static PrerenderedPath prerenderStroke(canvas::Path2D& path, const StrokeInfo& info);
+    static PrerenderedPath prerenderStroke(
+        const canvas::Path2D& path,
+        const StrokeInfo& info,
+        const PrerenderedPath::allocator_type& allocator = {}
+    );
 
     /**
      * Prerender fill of path (to be reused)
      * @param path
      * @param info
+     * @param allocator the allocator of the prerendered geometry
      * @return
      */
-    static PrerenderedPath prerenderFill(canvas::Path2D& path, const FillInfo& info);
+    static PrerenderedPath prerenderFill(
+        const canvas::Path2D& path,
+        const FillInfo& info,
+        const PrerenderedPath::allocator_type& allocator = {}
+    );
+
+
+    /**
+     * Prerendered path which geometry was uploaded to GPU (can be drawn repeatedly without any
+     * further uploads)
+     */
+    struct UploadedPath {
+        GeometryHandle geometry;
+        std::vector<DrawRecord> records = {};
+    };
+
+    /**
+     * Upload the prerendered primitives to device local memory
+     * @param item
+     * @return
+     */
+    boost::leaf::result<UploadedPath> upload(const PrerenderedPath& item);
+
+    /**
+     * Release the uploaded primitives
+     * @param item
+     */
+    void release(const UploadedPath& item);
+
+    /**
+     * Draw the uploaded primitives (queued into the current frame of renderer)
+     * @param item
+     */
+    void drawUploaded(const UploadedPath& item);
 
     /**
-     * Draw the prerendered primitives
+     * Draw the prerendered primitives (they are queued into the current frame of renderer - see
+     * Renderer::begin_frame)
      * @param item
      */
     void drawPrerendered(const PrerenderedPath& item);
 
+    /**
+     * Draw the whole uploaded scene (one bind of its geometry and draw per record)
+     * @param scene
+     * @return
+     */
+    boost::leaf::result<void> drawScene(const SceneGeometry& scene);
+
 private:
+    /**
+     * Prerender fill by triangulating every contour on CPU
+     * @param path
+     * @param info
+     * @param allocator the allocator of the prerendered geometry
+     * @return
+     */
+    static PrerenderedPath prerenderTriangulatedFill(
+        const canvas::Path2D& path,
+        const FillInfo& info,
+        const PrerenderedPath::allocator_type& allocator = {}
+    );
+
+    /**
+     * Prerender fill as triangle fan (drawn only to stencil) and bounding box covering it
+     * @param path
+     * @param info
+     * @param allocator the allocator of the prerendered geometry
+     * @return
+     */
+    static PrerenderedPath prerenderStencilFill(
+        const canvas::Path2D& path,
+        const FillInfo& info,
+        const PrerenderedPath::allocator_type& allocator = {}
+    );
+
     Renderer* renderer_;
 };
 
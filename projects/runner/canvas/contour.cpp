@@ -5,6 +5,24 @@
 
 namespace canvas {
 
+Contour::Contour(const allocator_type& allocator)
+    : points(allocator), point_flags(allocator) {
+}
+
+Contour::Contour(const Contour& other, const allocator_type& allocator)
+    : points(other.points, allocator), point_flags(other.point_flags, allocator), closed(other.closed) {
+}
+
+Contour::Contour(Contour&& other, const allocator_type& allocator)
+    : points(std::move(other.points), allocator),
+      point_flags(std::move(other.point_flags), allocator),
+      closed(other.closed) {
+}
+
+Contour::allocator_type Contour::get_allocator() const {
+    return points.get_allocator();
+}
+
 void Contour::close() {
     closed = true;
 }
@@ -79,23 +97,10 @@ Contour::ContourSegmentView Contour::segment_view(const SegmentViewOptions& opti
     return ContourSegmentView(this, options.ignore_close_segment);
 }
 
-std::vector<mff::Vector2f> Contour::flatten() const {
-    auto segments = segment_view();
-
+std::vector<mff::Vector2f> Contour::flatten(const FlattenOptions& options) const {
     std::vector<mff::Vector2f> result;
 
-    // flatten all segments in this contour
-    for (const auto& segment: segments) {
-        auto flattened = segment.flatten();
-
-        auto start = std::begin(flattened);
-
-        if (!result.empty() && (result.back() == *start)) {
-            start++;
-        }
-
-        result.insert(std::end(result), start, std::end(flattened));
-    }
+    flatten_into([&](const mff::Vector2f& point) { result.push_back(point); }, options);
 
     return result;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory_resource>
+#include <optional>
 #include <vector>
 
 #include <range/v3/all.hpp>
@@ -19,13 +21,47 @@ enum class PointFlag : std::uint8_t {
  * One concrete simple path (that means this path has no "interruptions" / "blank" spaces
  */
 struct Contour {
+    // the points are allocated by this allocator (so the contours of one document can live in arena)
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
     // The points of the path
-    std::vector<mff::Vector2f> points = {};
+    std::pmr::vector<mff::Vector2f> points = {};
     // Is the point start/end point, or control point?
-    std::vector<PointFlag> point_flags = {};
+    std::pmr::vector<PointFlag> point_flags = {};
     // is the contour closed?
     bool closed = false;
 
+    Contour() = default;
+    Contour(const Contour& other) = default;
+    Contour(Contour&& other) noexcept = default;
+    Contour& operator=(const Contour& other) = default;
+    Contour& operator=(Contour&& other) = default;
+
+    /**
+     * Create empty contour which allocates its points by the allocator
+     * @param allocator
+     */
+    explicit Contour(const allocator_type& allocator);
+
+    /**
+     * Copy the contour (the points of the copy are allocated by the allocator)
+     * @param other
+     * @param allocator
+     */
+    Contour(const Contour& other, const allocator_type& allocator);
+
+    /**
+     * Move the contour (the points are copied if the allocators are not equal)
+     * @param other
+     * @param allocator
+     */
+    Contour(Contour&& other, const allocator_type& allocator);
+
+    /**
+     * @return the allocator of points
+     */
+    allocator_type get_allocator() const;
+
     /**
      * Close the contour
      */
@@ -95,9 +131,20 @@ struct Contour {
 
     /**
      * Flatten this contour into points
+     * @param options
      * @return
      */
-    std::vector<mff::Vector2f> flatten() const; // TODO: add flatten options
+    std::vector<mff::Vector2f> flatten(const FlattenOptions& options = {}) const;
+
+    /**
+     * Flatten this contour and pass the points to the sink one by one (the joint points of
+     * segments are passed only once) - nothing is allocated, so the points can be written directly
+     * to reused buffer
+     * @param sink called as sink(point) for every point
+     * @param options
+     */
+    template <typename Sink>
+    void flatten_into(Sink&& sink, const FlattenOptions& options = {}) const;
 
     /**
      * Get the last tangent
@@ -143,4 +190,26 @@ struct Contour {
     ContourSegmentView segment_view(const SegmentViewOptions& options = {false}) const;
 };
 
+template <typename Sink>
+void Contour::flatten_into(Sink&& sink, const FlattenOptions& options) const {
+    std::optional<mff::Vector2f> last = std::nullopt;
+
+    for (const auto& segment: segment_view()) {
+        bool first = true;
+
+        segment.flatten_into(
+            [&](const mff::Vector2f& point) {
+                // the segment starts where the previous one ended
+                bool joint = first && last && (*last == point);
+                first = false;
+
+                if (joint) return;
+
+                last = point;
+                sink(point);
+            },
+            options);
+    }
+}
+
 }
\ No newline at end of file
@@ -99,7 +99,7 @@ std::float_t LineSegment2f::inner_angle_between(const LineSegment2f& other) cons
 LineSegment2f LineSegment2f::offset(std::float_t dist) const {
     if (vector().isZero()) return *this;
 
-    auto normalized = vector().normalized() * dist;
+    mff::Vector2f normalized = vector().normalized() * dist;
 
     return *this + mff::Vector2f(-normalized[1], normalized[0]);
 }
@@ -2,13 +2,39 @@
 
 namespace canvas {
 
+Outline::Outline(const allocator_type& allocator)
+    : contours_(allocator) {
+}
+
+Outline::Outline(const Outline& other, const allocator_type& allocator)
+    : contours_(other.contours_, allocator) {
+}
+
+Outline::Outline(Outline&& other, const allocator_type& allocator)
+    : contours_(std::move(other.contours_), allocator) {
+}
+
 void Outline::add_contour(const Contour& contour) {
     if (contour.empty()) return;
 
     contours_.push_back(contour);
 }
 
-const std::vector<Contour>& Outline::get_contours() const {
+void Outline::add_contour(Contour&& contour) {
+    if (contour.empty()) return;
+
+    contours_.push_back(std::move(contour));
+}
+
+Contour& Outline::start_contour() {
+    return contours_.emplace_back();
+}
+
+Contour& Outline::last_contour() {
+    return contours_.back();
+}
+
+const std::pmr::vector<Contour>& Outline::get_contours() const {
     return contours_;
 }
 
@@ -18,4 +44,8 @@ void Outline::transform(const Transform2f& transform) {
     }
 }
 
+Outline::allocator_type Outline::get_allocator() const {
+    return contours_.get_allocator();
+}
+
 }
\ No newline at end of file
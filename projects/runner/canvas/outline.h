@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <vector>
 
 #include "./math.h"
@@ -12,17 +13,65 @@ namespace canvas {
  */
 class Outline {
 public:
+    // the contours (and their points) are allocated by this allocator
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    Outline() = default;
+    Outline(const Outline& other) = default;
+    Outline(Outline&& other) noexcept = default;
+    Outline& operator=(const Outline& other) = default;
+    Outline& operator=(Outline&& other) = default;
+
     /**
-     * Add new contour
+     * Create empty outline which allocates its contours by the allocator
+     * @param allocator
+     */
+    explicit Outline(const allocator_type& allocator);
+
+    /**
+     * Copy the outline (the contours of the copy are allocated by the allocator)
+     * @param other
+     * @param allocator
+     */
+    Outline(const Outline& other, const allocator_type& allocator);
+
+    /**
+     * Move the outline (the contours are copied if the allocators are not equal)
+     * @param other
+     * @param allocator
+     */
+    Outline(Outline&& other, const allocator_type& allocator);
+
+    /**
+     * Add new contour (it is copied by the allocator of this outline)
      * @param contour
      */
     void add_contour(const Contour& contour);
 
+    /**
+     * Add new contour (its points are moved if it uses the same allocator as this outline)
+     * @param contour
+     */
+    void add_contour(Contour&& contour);
+
+    /**
+     * Start new empty contour at the end of outline (the points have to be added to it before the
+     * outline is used - the outline does not contain empty contours)
+     * @return the new contour
+     */
+    Contour& start_contour();
+
+    /**
+     * Get the last contour (the outline must not be empty)
+     * @return
+     */
+    Contour& last_contour();
+
     /**
      * Get all contours
      * @return
      */
-    const std::vector<Contour>& get_contours() const;
+    const std::pmr::vector<Contour>& get_contours() const;
 
     /**
      * Transform all contained contours
@@ -30,8 +79,13 @@ public:
      */
     void transform(const Transform2f& transform);
 
+    /**
+     * @return the allocator of contours
+     */
+    allocator_type get_allocator() const;
+
 private:
-    std::vector<Contour> contours_ = {};
+    std::pmr::vector<Contour> contours_ = {};
 };
 
-}
\ No newline at end of file
+}
@@ -4,55 +4,79 @@
 
 namespace canvas {
 
+Path2D::Path2D(const allocator_type& allocator)
+    : outline_(allocator) {
+}
+
+Path2D::Path2D(Outline outline)
+    : outline_(std::move(outline)) {
+}
+
 void Path2D::close_path() {
-    current_contour_.close();
+    if (contour_open_) current_contour().close();
 }
 
 void Path2D::move_to(const mff::Vector2f& point) {
     end_current_contour();
-    current_contour_.add_endpoint(point);
+    current_contour().add_endpoint(point);
 }
 
 void Path2D::line_to(const mff::Vector2f& point) {
-    current_contour_.add_endpoint(point);
+    current_contour().add_endpoint(point);
 }
 
 void Path2D::quad_to(const mff::Vector2f& control, const mff::Vector2f& point) {
-    current_contour_.add_quadratic(control, point);
+    current_contour().add_quadratic(control, point);
 }
 
 void Path2D::bezier_to(const mff::Vector2f& control0, const mff::Vector2f& control1, const mff::Vector2f& point) {
-    current_contour_.add_cubic(control0, control1, point);
+    current_contour().add_cubic(control0, control1, point);
 }
 
 void Path2D::rect(const Rectf& r) {
     end_current_contour();
-    current_contour_.add_endpoint(r.top_left());
-    current_contour_.add_endpoint(r.top_right());
-    current_contour_.add_endpoint(r.bottom_right());
-    current_contour_.add_endpoint(r.bottom_left());
-    current_contour_.close();
+
+    auto& contour = current_contour();
+    contour.add_endpoint(r.top_left());
+    contour.add_endpoint(r.top_right());
+    contour.add_endpoint(r.bottom_right());
+    contour.add_endpoint(r.bottom_left());
+    contour.close();
 }
 
 void Path2D::ellipse(const mff::Vector2f& center, const mff::Vector2f& axes) {
     end_current_contour();
 
     Transform2f transform = Transform2f::from_scale(axes).translate(center);
-    current_contour_.add_ellipse(transform);
+    current_contour().add_ellipse(transform);
 
     end_current_contour();
 }
 
-Outline Path2D::get_outline() {
-    end_current_contour();
+const Outline& Path2D::get_outline() const& {
     return outline_;
 }
 
-void Path2D::end_current_contour() {
-    if (!current_contour_.empty()) {
-        outline_.add_contour(current_contour_);
-        current_contour_ = Contour{};
+Outline Path2D::get_outline()&& {
+    contour_open_ = false;
+    return std::move(outline_);
+}
+
+Path2D::allocator_type Path2D::get_allocator() const {
+    return outline_.get_allocator();
+}
+
+Contour& Path2D::current_contour() {
+    if (!contour_open_) {
+        outline_.start_contour();
+        contour_open_ = true;
     }
+
+    return outline_.last_contour();
+}
+
+void Path2D::end_current_contour() {
+    contour_open_ = false;
 }
 
 void Path2D::transform(const Transform2f& transform) {
@@ -60,11 +84,11 @@ void Path2D::transform(const Transform2f& transform) {
     outline_.transform(transform);
 }
 
-Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands) {
+Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands, const allocator_type& allocator) {
     mff::Vector2f last_control_point = {0.0f, 0.0f};
     mff::Vector2f last_point = {0.0f, 0.0f};
 
-    Path2D result = {};
+    Path2D result(allocator);
 
     auto get_pos = [&](svg::Position pos_rel, const mff::Vector2f& pos) {
         mff::Vector2f result;
@@ -111,7 +135,7 @@ Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands) {
 
                     last_control_point = last_point;
                 },
-                [&](svg::Commands_::VerticalLineto vertical_line_to) -> void {
+                [&](const svg::Commands_::VerticalLineto& vertical_line_to) -> void {
                     for (const auto& pos: vertical_line_to.coordinates) {
                         auto y = vertical_line_to.position == svg::Position::Absolute ? pos : last_point.y() + pos;
                         mff::Vector2f p = {last_point.x(), y};
@@ -121,7 +145,7 @@ Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands) {
 
                     last_control_point = last_point;
                 },
-                [&](svg::Commands_::HorizontalLineto horizontal_line_to) -> void {
+                [&](const svg::Commands_::HorizontalLineto& horizontal_line_to) -> void {
                     for (const auto& pos: horizontal_line_to.coordinates) {
                         auto x = horizontal_line_to.position == svg::Position::Absolute ? pos : last_point.x() + pos;
                         mff::Vector2f p = {x, last_point.y()};
@@ -131,7 +155,7 @@ Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands) {
 
                     last_control_point = last_point;
                 },
-                [&](svg::Commands_::Curveto curve_to) -> void {
+                [&](const svg::Commands_::Curveto& curve_to) -> void {
                     for (const auto& pos: curve_to.coordinates) {
                         auto[c1, c2, p] = pos;
 
@@ -147,7 +171,7 @@ Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands) {
                         last_control_point = rc2;
                     }
                 },
-                [&](svg::Commands_::SmoothCurveto smooth_curve_to) -> void {
+                [&](const svg::Commands_::SmoothCurveto& smooth_curve_to) -> void {
                     for (const auto& pos: smooth_curve_to.coordinates) {
                         auto[c2, p] = pos;
 
@@ -160,7 +184,7 @@ Path2D Path2D::from_svg_commands(std::vector<svg::Command> commands) {
                         last_control_point = rc2;
                     }
                 },
-                [&](svg::Commands_::Closepath close) -> void {
+                [&](const svg::Commands_::Closepath& close) -> void {
                     result.close_path();
                 }
             },
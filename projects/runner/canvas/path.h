@@ -7,11 +7,36 @@
 
 namespace canvas {
 
+/**
+ * Rule which decides which points are inside of the path (see SVG fill-rule)
+ */
+enum class FillRule {
+    NonZero,
+    EvenOdd
+};
+
 /**
  * This path represents the SVG paths (<path />, <ellipse />, <circle /> etc.)
  */
 class Path2D {
 public:
+    // the contours (and their points) are allocated by this allocator
+    using allocator_type = Outline::allocator_type;
+
+    Path2D() = default;
+
+    /**
+     * Create empty path which allocates its contours by the allocator
+     * @param allocator
+     */
+    explicit Path2D(const allocator_type& allocator);
+
+    /**
+     * Create path from outline (the contours are moved, not copied)
+     * @param outline
+     */
+    explicit Path2D(Outline outline);
+
     /**
      * Close the current path
      */
@@ -58,17 +83,24 @@ public:
     void ellipse(const mff::Vector2f& center, const mff::Vector2f& axes);
 
     /**
-     * Get the resulting outline (non const, because we have to end the current contour)
+     * Get the resulting outline (view of the contours of this path - including the current one)
      * @return
      */
-    Outline get_outline();
+    const Outline& get_outline() const&;
+
+    /**
+     * Move the resulting outline out of this path (so the contours are not copied)
+     * @return
+     */
+    Outline get_outline()&&;
 
     /**
      * Build Path2D from SVG commands
      * @param commands
+     * @param allocator the allocator of the contours of the resulting path
      * @return
      */
-    static Path2D from_svg_commands(std::vector<svg::Command> commands);
+    static Path2D from_svg_commands(std::vector<svg::Command> commands, const allocator_type& allocator = {});
 
     /**
      * Transform all contours contained in this path
@@ -76,10 +108,27 @@ public:
      */
     void transform(const Transform2f& transform);
 
+    /**
+     * @return the allocator of contours
+     */
+    allocator_type get_allocator() const;
+
 private:
+    // the current contour (if it is open) is the last contour of outline
     Outline outline_ = {};
-    Contour current_contour_ = {};
+    // are the next points added to the last contour?
+    bool contour_open_ = false;
 
+    /**
+     * Get the contour to which the next points are added (new one is started if the last one was
+     * ended)
+     * @return
+     */
+    Contour& current_contour();
+
+    /**
+     * End the current contour (the next points start new contour)
+     */
     void end_current_contour();
 };
 
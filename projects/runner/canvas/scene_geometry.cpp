@@ -0,0 +1,64 @@
+#include "./scene_geometry.h"
+
+namespace canvas {
+
+void SceneGeometry::reserve(std::size_t vertex_count, std::size_t index_count, std::size_t record_count) {
+    vertices_.reserve(vertex_count);
+    indices_.reserve(index_count);
+    records_.reserve(record_count);
+}
+
+void SceneGeometry::add(const Canvas::PrerenderedPath& path) {
+    auto first_index = static_cast<std::uint32_t>(indices_.size());
+    auto vertex_offset = static_cast<std::int32_t>(vertices_.size());
+
+    // the indices are relative to the base vertex so we can copy them as they are and just move
+    // the ranges
+    for (auto record: path.records) {
+        record.range.first_index += first_index;
+        record.range.vertex_offset += vertex_offset;
+        records_.push_back(record);
+    }
+
+    vertices_.insert(std::end(vertices_), std::begin(path.vertices), std::end(path.vertices));
+    indices_.insert(std::end(indices_), std::begin(path.indices), std::end(path.indices));
+}
+
+void SceneGeometry::clear() {
+    vertices_.clear();
+    indices_.clear();
+    records_.clear();
+}
+
+boost::leaf::result<void> SceneGeometry::upload(Renderer* renderer) {
+    release(renderer);
+
+    LEAF_AUTO_TO(geometry_, renderer->upload(vertices_, indices_));
+
+    return {};
+}
+
+void SceneGeometry::release(Renderer* renderer) {
+    if (!geometry_) return;
+
+    renderer->release(geometry_.value());
+    geometry_ = std::nullopt;
+}
+
+const std::vector<Vertex>& SceneGeometry::get_vertices() const {
+    return vertices_;
+}
+
+const std::vector<std::uint32_t>& SceneGeometry::get_indices() const {
+    return indices_;
+}
+
+const std::vector<DrawRecord>& SceneGeometry::get_records() const {
+    return records_;
+}
+
+std::optional<GeometryHandle> SceneGeometry::get_geometry() const {
+    return geometry_;
+}
+
+}
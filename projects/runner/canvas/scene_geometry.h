@@ -0,0 +1,70 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <mff/leaf.h>
+
+#include "../renderer/renderer.h"
+#include "./canvas.h"
+
+namespace canvas {
+
+/**
+ * Arena packing all the prerendered paths of one document (scene) into one vertex and one index
+ * array. Every record is just range in these arrays (first index, index count, base vertex), so
+ * the whole scene is uploaded to GPU as one geometry and drawn with one bind and draw per record.
+ */
+class SceneGeometry {
+public:
+    /**
+     * Reserve space for the specified number of vertices, indices and records
+     * @param vertex_count
+     * @param index_count
+     * @param record_count
+     */
+    void reserve(std::size_t vertex_count, std::size_t index_count, std::size_t record_count);
+
+    /**
+     * Append all the records of prerendered path to the scene (in the drawing order)
+     * @param path
+     */
+    void add(const Canvas::PrerenderedPath& path);
+
+    /**
+     * Remove all the records from the scene (the uploaded geometry is kept until release)
+     */
+    void clear();
+
+    /**
+     * Upload the scene geometry to device local memory (releasing the previously uploaded one)
+     * @param renderer
+     * @return
+     */
+    boost::leaf::result<void> upload(Renderer* renderer);
+
+    /**
+     * Release the uploaded geometry
+     * @param renderer
+     */
+    void release(Renderer* renderer);
+
+    const std::vector<Vertex>& get_vertices() const;
+    const std::vector<std::uint32_t>& get_indices() const;
+    const std::vector<DrawRecord>& get_records() const;
+
+    /**
+     * Get the handle to the uploaded geometry (if it was uploaded)
+     * @return
+     */
+    std::optional<GeometryHandle> get_geometry() const;
+
+private:
+    std::vector<Vertex> vertices_ = {};
+    std::vector<std::uint32_t> indices_ = {};
+    std::vector<DrawRecord> records_ = {};
+
+    std::optional<GeometryHandle> geometry_ = std::nullopt;
+};
+
+}
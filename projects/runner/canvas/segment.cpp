@@ -1,5 +1,7 @@
 #include "./segment.h"
 
+#include <algorithm>
+
 namespace canvas {
 
 // Legendre-Gauss coefficients
@@ -85,7 +87,7 @@ mff::Vector2f Segment::derivative(std::float_t t) const {
     return std::visit(
         mff::overloaded{
             [&](const Kind_::Line& line) -> mff::Vector2f {
-                return (line.baseline.to - line.baseline.from) * dt;
+                return line.baseline.to - line.baseline.from;
             },
             [&](const Kind_::Quadratic& quad) -> mff::Vector2f {
                 return (2 * dt * (quad.control - quad.baseline.from)
@@ -195,29 +197,48 @@ std::pair<Segment, Segment> Segment::split(std::float_t t) const {
     );
 }
 
-std::vector<mff::Vector2f> Segment::flatten(FlattenOptions options) const {
-    using result_t = std::vector<mff::Vector2f>;
+std::size_t Segment::flatten_steps(const FlattenOptions& options) const {
+    // the translation does not change the differences of control points so only the linear part
+    // of the transform is needed
+    const auto& linear = options.transform.transform;
 
-    return std::visit(
+    // Wang's formula: n = ceil(sqrt(d * (d - 1) / 8 * max |P(i) - 2 P(i + 1) + P(i + 2)| / tolerance))
+    std::float_t max_difference = std::visit(
         mff::overloaded{
-            [&](const Kind_::Line& line) -> result_t {
-                return {line.baseline.from, line.baseline.to};
+            [&](const Kind_::Line&) -> std::float_t {
+                return 0.0f;
             },
-            [&](const auto& other) -> result_t {
-                // super simple, just split the curve into multiple steps
-                std::float_t step = 1.0f / options.steps;
+            [&](const Kind_::Quadratic& quad) -> std::float_t {
+                auto difference = quad.baseline.from - 2.0f * quad.control + quad.baseline.to;
 
-                std::vector<mff::Vector2f> result(options.steps + 1);
-
-                for (int i = 0; i <= options.steps; i++) {
-                    result[i] = evaluate(step * ((std::float_t) i));
-                }
+                return (2.0f * 1.0f / 8.0f) * (linear * difference).norm();
+            },
+            [&](const Kind_::Cubic& cubic) -> std::float_t {
+                auto difference1 = cubic.baseline.from - 2.0f * cubic.control.from + cubic.control.to;
+                auto difference2 = cubic.control.from - 2.0f * cubic.control.to + cubic.baseline.to;
 
-                return result;
+                return (3.0f * 2.0f / 8.0f)
+                    * std::max((linear * difference1).norm(), (linear * difference2).norm());
             }
         },
         data
     );
+
+    if (!(max_difference > 0.0f) || !(options.tolerance > 0.0f)) return 1;
+
+    auto steps = std::ceil(std::sqrt(max_difference / options.tolerance));
+
+    if (!std::isfinite(steps)) return options.max_steps;
+
+    return std::clamp<std::size_t>(static_cast<std::size_t>(steps), 1, options.max_steps);
+}
+
+std::vector<mff::Vector2f> Segment::flatten(FlattenOptions options) const {
+    std::vector<mff::Vector2f> result;
+
+    flatten_into([&](const mff::Vector2f& point) { result.push_back(point); }, options);
+
+    return result;
 }
 
 bool Segment::is_line() const {
@@ -17,8 +17,24 @@ enum class SegmentKind {
     Cubic
 };
 
+/**
+ * How precisely should be the curves flattened
+ */
 struct FlattenOptions {
-    std::size_t steps = 15;
+    /**
+     * Maximal distance (in screen space) of the flattened polyline from the curve
+     */
+    std::float_t tolerance = 0.25f;
+
+    /**
+     * Transform from the segment coordinates to screen space (in which is the tolerance measured)
+     */
+    Transform2f transform = Transform2f::identity();
+
+    /**
+     * Upper bound of lines to which is one curve flattened (for degenerate transforms)
+     */
+    std::size_t max_steps = 1024;
 };
 
 namespace Kind_ {
@@ -148,12 +164,47 @@ struct Segment {
     std::pair<Segment, Segment> split(std::float_t t) const;
 
     /**
-     * Flatten this segment to points
+     * Get the number of lines to which is this segment flattened so it is within the tolerance -
+     * estimated by Wang's formula from the second differences of control points (so it depends on
+     * the size of curve in screen space and its curvature)
+     * @param options
+     * @return
+     */
+    std::size_t flatten_steps(const FlattenOptions& options = {}) const;
+
+    /**
+     * Flatten this segment to points (the curves are sampled uniformly in flatten_steps)
      * @param options
      * @return
      */
     std::vector<mff::Vector2f> flatten(FlattenOptions options = {}) const;
 
+    /**
+     * Flatten this segment and pass the points to the sink one by one (so they can be written
+     * directly to the final buffer without any intermediate allocations)
+     * @param sink called as sink(point) for every point (including both end points)
+     * @param options
+     */
+    template <typename Sink>
+    void flatten_into(Sink&& sink, const FlattenOptions& options = {}) const {
+        if (const auto* line = std::get_if<Kind_::Line>(&data)) {
+            sink(line->baseline.from);
+            sink(line->baseline.to);
+            return;
+        }
+
+        // split the curve into as many uniform steps as needed to keep the tolerance
+        auto steps = flatten_steps(options);
+        std::float_t step = 1.0f / steps;
+
+        for (std::size_t i = 0; i < steps; i++) {
+            sink(evaluate(step * ((std::float_t) i)));
+        }
+
+        // end exactly at the end point (so the following segment can be joined)
+        sink(get_baseline().to);
+    }
+
     using SegmentHandler = std::function<void(const Segment&)>;
 
     // Reason why not return segment is future-proofing (we may do some splitting in future)
@@ -3,334 +3,687 @@
 
 #include "./stroke.h"
 
+#include <algorithm>
+
+#include <mff/utils.h>
+
 #include "./outline.h"
 
 namespace canvas {
 
-// we do stroking manually
-// TODO: create strokes using offseting Contours
-StrokeResult get_stroke(
-    const std::vector<mff::Vector2f>& flattened,
-    const StrokeStyle& style,
-    bool loop
-) {
-    if (flattened.size() < 2) return {};
+namespace {
 
-    std::vector<mff::Vector2f> result_vertices;
-    std::vector<std::uint32_t> result_indices;
+// how many times can be offset curve split to get within the tolerance
+const std::size_t MAX_OFFSET_DEPTH = 8;
 
-    auto half_width = style.line_width / 2.0f;
+/**
+ * Get the left normal of direction
+ */
+mff::Vector2f get_left_normal(const mff::Vector2f& direction) {
+    return {-direction[1], direction[0]};
+}
 
-    // get left perpendicular vector
-    auto get_perpendicular = [](const mff::Vector2f& a) -> mff::Vector2f { return (mff::Vector2f{a[1], -a[0]}); };
+/**
+ * Get all the points defining the segment (end points and control points in order)
+ */
+std::vector<mff::Vector2f> get_segment_points(const Segment& segment) {
+    return std::visit(
+        mff::overloaded{
+            [](const Kind_::Line& line) -> std::vector<mff::Vector2f> {
+                return {line.baseline.from, line.baseline.to};
+            },
+            [](const Kind_::Quadratic& quad) -> std::vector<mff::Vector2f> {
+                return {quad.baseline.from, quad.control, quad.baseline.to};
+            },
+            [](const Kind_::Cubic& cubic) -> std::vector<mff::Vector2f> {
+                return {cubic.baseline.from, cubic.control.from, cubic.control.to, cubic.baseline.to};
+            }
+        },
+        segment.data
+    );
+}
 
-    // if the first and last element coincide then skip the last element
-    bool skip_last = loop && mff::is_approx_zero(flattened.front() - flattened.back());
-    auto flattened_size = (skip_last ? flattened.size() - 1 : flattened.size());
-    // helper to get the correct index (including negatie indices)
-    auto get_index = [&](std::int32_t index) -> std::size_t {
-        if (index < 0) return (flattened_size - std::abs(index % ((std::int32_t) flattened_size))) % flattened_size;
-        return index % flattened_size;
-    };
+/**
+ * Get the direction in which the segment starts (the first control point which differs from start)
+ */
+std::optional<mff::Vector2f> get_start_direction(const Segment& segment) {
+    auto points = get_segment_points(segment);
 
-    // get the point with correct index
-    auto get_point = [&](std::int32_t index) -> mff::Vector2f { return flattened[get_index(index)]; };
-    auto add_vert = [&](const mff::Vector2f& a) { result_vertices.push_back(a); };
+    for (std::size_t i = 1; i < points.size(); i++) {
+        if (points[i] != points[0]) return (points[i] - points[0]).normalized();
+    }
 
-    // add triangle_indices
-    auto add_indices_triangle = [&](std::size_t p1, std::size_t p2, std::size_t p3) {
-        result_indices.push_back(p1);
-        result_indices.push_back(p2);
-        result_indices.push_back(p3);
-    };
+    return std::nullopt;
+}
 
-    // add rectangle indices starting with specified index
-    auto add_indices_rectangle = [&](std::size_t from) {
-        add_indices_triangle(from, from + 2, from + 1);
-        add_indices_triangle(from + 1, from + 2, from + 3);
-    };
+/**
+ * Get the direction in which the segment ends (from the last control point which differs from end)
+ */
+std::optional<mff::Vector2f> get_end_direction(const Segment& segment) {
+    auto points = get_segment_points(segment);
+    auto last = points.size() - 1;
 
-    // helper method to add line end caps + doc paper
-    auto add_cap = [&](const mff::Vector2f& p0, const mff::Vector2f& p1, bool start) {
-        auto curr_vertices_ix = result_vertices.size();
+    for (std::size_t i = 1; i < points.size(); i++) {
+        if (points[last - i] != points[last]) return (points[last] - points[last - i]).normalized();
+    }
 
-        if (start) {
-            auto direction = (p1 - p0).normalized();
-            mff::Vector2f extrusion = direction * half_width;
+    return std::nullopt;
+}
 
-            auto base_point = p0;
+/**
+ * Replace curves which degenerated to line (all the control points on the end points) by lines, so
+ * they can be offset
+ */
+Segment simplify_segment(const Segment& segment) {
+    auto points = get_segment_points(segment);
+    auto baseline = segment.get_baseline();
 
-            if (std::holds_alternative<LineCap_::Square>(style.line_cap)) {
-                // if square cap move start point back
-                base_point = p0 - extrusion;
+    bool degenerate = std::all_of(
+        std::begin(points),
+        std::end(points),
+        [&](const mff::Vector2f& p) { return p == baseline.from || p == baseline.to; });
+
+    return degenerate ? Segment::line(baseline) : segment;
+}
+
+/**
+ * Append line to the point (if the contour does not end there already)
+ */
+void append_endpoint(Contour& contour, const mff::Vector2f& point) {
+    if (contour.empty() || contour.points.back() != point) contour.add_endpoint(point);
+}
+
+/**
+ * Append segment to the contour (if it does not start at the end of contour, the gap is connected
+ * by line)
+ */
+void append_segment(Contour& contour, const Segment& segment) {
+    append_endpoint(contour, segment.get_baseline().from);
+
+    std::visit(
+        mff::overloaded{
+            [&](const Kind_::Line& line) {
+                contour.add_endpoint(line.baseline.to);
+            },
+            [&](const Kind_::Quadratic& quad) {
+                contour.add_quadratic(quad.control, quad.baseline.to);
+            },
+            [&](const Kind_::Cubic& cubic) {
+                contour.add_cubic(cubic.control.from, cubic.control.to, cubic.baseline.to);
             }
+        },
+        segment.data
+    );
+}
 
-            if (std::holds_alternative<LineCap_::Round>(style.line_cap)) {
-                // calculate the angle from and to which generate half circle
-                std::float_t step = M_PI / (2.0 * half_width);
-                std::float_t beta = std::acos(direction[0]) + M_PI_2;
-                if (direction[1] < 0.0f) beta = M_PI - beta;
-                std::float_t beta_to = beta + M_PI; // half circl
-
-                beta += step;
-                // add the half circle
-                while (beta < beta_to) {
-                    add_vert({std::cos(beta) * half_width + p0[0], std::sin(beta) * half_width + p0[1]});
-                    beta += step;
-                }
+/**
+ * Close the contour (the closing line is implicit, so the last line to the first point is removed)
+ */
+void close_contour(Contour& contour) {
+    auto size = contour.points.size();
+
+    if (size > 2
+        && contour.points.back() == contour.points.front()
+        && contour.point_flags[size - 2] == PointFlag::CONCRETE) {
+        contour.points.pop_back();
+        contour.point_flags.pop_back();
+    }
 
-                std::uint32_t after_add_vertices_ix = result_vertices.size();
+    contour.close();
+}
 
-                // generate the indices
-                for (std::uint32_t indice = curr_vertices_ix; indice < after_add_vertices_ix; indice++) {
-                    add_indices_triangle(after_add_vertices_ix + 1, indice, indice + 1);
-                }
+/**
+ * Append circular arc around center (from angle to angle + sweep, sweep can be negative) - it is
+ * approximated by cubic curve for every quarter circle
+ */
+void append_arc(
+    Contour& contour,
+    const mff::Vector2f& center,
+    std::float_t radius,
+    std::float_t from_angle,
+    std::float_t sweep
+) {
+    auto pieces = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::abs(sweep) / M_PI_2 - 1e-4f)));
+    auto piece_sweep = sweep / pieces;
+    // https://pomax.github.io/bezierinfo/#circles_cubic
+    auto k = (4.0f / 3.0f) * std::tan(piece_sweep / 4.0f) * radius;
 
-                curr_vertices_ix = after_add_vertices_ix;
-            }
+    for (std::size_t i = 0; i < pieces; i++) {
+        auto angle0 = from_angle + piece_sweep * i;
+        auto angle1 = angle0 + piece_sweep;
+
+        mff::Vector2f direction0 = {std::cos(angle0), std::sin(angle0)};
+        mff::Vector2f direction1 = {std::cos(angle1), std::sin(angle1)};
+
+        mff::Vector2f p0 = center + direction0 * radius;
+        mff::Vector2f p1 = center + direction1 * radius;
+
+        append_segment(
+            contour,
+            Segment::cubic({p0, p1}, {p0 + get_left_normal(direction0) * k, p1 - get_left_normal(direction1) * k}));
+    }
+}
 
-            extrusion = get_perpendicular(extrusion);
+/**
+ * Append the segment offset by distance - the offset approximation is split until it is within the
+ * tolerance (measured at a few points in screen space)
+ */
+void append_offset_segment(
+    Contour& contour,
+    const Segment& segment,
+    std::float_t distance,
+    const FlattenOptions& options,
+    std::size_t depth = 0
+) {
+    if (segment.is_line()) {
+        append_segment(contour, Segment::line(segment.get_baseline().offset(distance)));
+        return;
+    }
 
-            add_vert(base_point + extrusion);
-            add_vert(base_point - extrusion);
+    bool precise = true;
 
-            add_indices_rectangle(curr_vertices_ix);
-        } else {
-            auto normal = (p0 - p1).normalized();
-            mff::Vector2f extrusion = normal * half_width;
+    segment.offset(
+        distance,
+        [&](const Segment& offset) {
+            if (depth >= MAX_OFFSET_DEPTH) return;
 
-            auto base_point = p0;
+            for (auto t: {0.25f, 0.5f, 0.75f}) {
+                mff::Vector2f expected = segment.evaluate(t) + segment.normal(t) * distance;
+                mff::Vector2f error = options.transform.transform * (expected - offset.evaluate(t));
 
-            if (std::holds_alternative<LineCap_::Square>(style.line_cap)) {
-                // if square cap move start point forward
-                base_point = p0 + extrusion;
+                // the normal is not defined at cusps (the error is NaN there and it is skipped)
+                if (error.norm() > options.tolerance) precise = false;
             }
+        });
 
-            extrusion = get_perpendicular(extrusion);
+    if (precise) {
+        segment.offset(distance, [&](const Segment& offset) { append_segment(contour, offset); });
+        return;
+    }
 
-            add_vert(base_point + extrusion);
-            add_vert(base_point - extrusion);
+    auto[first, second] = segment.split(0.5f);
 
-            curr_vertices_ix = result_vertices.size();
+    append_offset_segment(contour, first, distance, options, depth + 1);
+    append_offset_segment(contour, second, distance, options, depth + 1);
+}
 
-            if (std::holds_alternative<LineCap_::Round>(style.line_cap)) {
-                // calculate the angle from and to which generate half circle
-                std::float_t step = M_PI / (2.0 * half_width);
-                std::float_t beta = std::acos(normal[0]) + M_PI_2;
-                if (normal[1] < 0.0f) beta = M_PI - beta;
-                std::float_t beta_to = beta - M_PI; // half circl
+/**
+ * Append the join of two offset segments meeting at pivot (incoming and outgoing directions are
+ * normalized, the offset is on the left side at distance)
+ */
+void append_join(
+    Contour& contour,
+    const mff::Vector2f& pivot,
+    const mff::Vector2f& incoming,
+    const mff::Vector2f& outgoing,
+    std::float_t distance,
+    const LineJoin& join
+) {
+    auto cross = incoming[0] * outgoing[1] - incoming[1] * outgoing[0];
+    auto dot = incoming.dot(outgoing);
 
-                beta -= step;
-                // add the half circle
-                while (beta > beta_to) {
-                    add_vert({std::cos(beta) * half_width + p0[0], std::sin(beta) * half_width + p0[1]});
-                    beta -= step;
-                }
+    // the segments continue in the same direction
+    if (dot > 0.0f && std::abs(cross) < 1e-6f) return;
 
-                std::uint32_t after_add_vertices_ix = result_vertices.size();
+    // the inner side (the offset segments overlap) - connect them through the pivot, so all the
+    // overlapping parts have the same winding
+    if (cross > 0.0f) {
+        append_endpoint(contour, pivot);
+        return;
+    }
 
-                // generate the indices
-                for (std::uint32_t indice = curr_vertices_ix - 1; indice < (after_add_vertices_ix - 1); indice++) {
-                    add_indices_triangle(indice + 1, indice, curr_vertices_ix - 2);
-                }
+    std::visit(
+        mff::overloaded{
+            [&](const LineJoin_::Bevel&) {
+                // the gap is connected by line when the next segment is appended
+            },
+            [&](const LineJoin_::Miter& miter) {
+                // the ratio of miter length and stroke width is 1 / cos(turn angle / 2)
+                auto cos_half_turn = std::sqrt(std::max(0.0f, (1.0f + dot) / 2.0f));
+
+                if (cos_half_turn * miter.value < 1.0f) return;
+
+                mff::Vector2f normals = get_left_normal(incoming) + get_left_normal(outgoing);
+                append_endpoint(contour, pivot + normals * (distance / (1.0f + dot)));
+            },
+            [&](const LineJoin_::Round&) {
+                auto from = get_left_normal(incoming);
+                auto from_angle = std::atan2(from[1], from[0]);
+                // the outer side is always turning clockwise
+                auto sweep = -std::acos(std::clamp(dot, -1.0f, 1.0f));
+
+                append_arc(contour, pivot, distance, from_angle, sweep);
+            }
+        },
+        join
+    );
+}
+
+/**
+ * Append the cap at the end point of stroke (from the left side to the right side)
+ */
+void append_cap(
+    Contour& contour,
+    const mff::Vector2f& point,
+    const mff::Vector2f& direction,
+    std::float_t distance,
+    const LineCap& cap
+) {
+    mff::Vector2f normal = get_left_normal(direction) * distance;
+
+    std::visit(
+        mff::overloaded{
+            [&](const LineCap_::Butt&) {
+                append_endpoint(contour, point + normal);
+                append_endpoint(contour, point - normal);
+            },
+            [&](const LineCap_::Square&) {
+                mff::Vector2f extension = direction * distance;
 
-                curr_vertices_ix = after_add_vertices_ix;
+                append_endpoint(contour, point + normal);
+                append_endpoint(contour, point + normal + extension);
+                append_endpoint(contour, point - normal + extension);
+                append_endpoint(contour, point - normal);
+            },
+            [&](const LineCap_::Round&) {
+                append_endpoint(contour, point + normal);
+                append_arc(contour, point, distance, std::atan2(normal[1], normal[0]), -M_PI);
             }
+        },
+        cap
+    );
+}
+
+/**
+ * Append the left side of the segments (offset segments and joins between them)
+ */
+void append_side(
+    Contour& contour,
+    const std::vector<Segment>& segments,
+    std::float_t distance,
+    const StrokeStyle& style,
+    const FlattenOptions& options,
+    bool closed
+) {
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        if (i > 0 || closed) {
+            const auto& previous = segments[(i + segments.size() - 1) % segments.size()];
+
+            append_join(
+                contour,
+                segments[i].get_baseline().from,
+                get_end_direction(previous).value(),
+                get_start_direction(segments[i]).value(),
+                distance,
+                style.line_join);
         }
-    };
 
-    auto add_step = [&](const mff::Vector2f& pL, const mff::Vector2f& p0, const mff::Vector2f& pR) {
-        mff::Vector2f dL = (p0 - pL); // left connection
-        mff::Vector2f dR = (pR - p0); // right connection
+        append_offset_segment(contour, segments[i], distance, options);
+    }
+}
 
-        dL = dL.normalized(); // normalize
-        dR = dR.normalized();
+/**
+ * Get the largest angle of arc step, so the chord of the arc (with radius in user space) is within
+ * the tolerance in screen space (the arc is scaled at most by the largest singular value of the
+ * linear part of transform)
+ */
+std::float_t get_max_arc_step(std::float_t radius, const FlattenOptions& options) {
+    const auto& linear = options.transform.transform;
+    auto frobenius = linear.squaredNorm();
+    auto determinant = linear.determinant();
+    auto scale = std::sqrt((frobenius + std::sqrt(std::max(0.0f, frobenius * frobenius - 4.0f * determinant * determinant))) / 2.0f);
 
-        auto dLp = get_perpendicular(dL); // get perpendiculars to left and right parts
-        auto dRp = get_perpendicular(dR);
+    auto screen_radius = radius * scale;
+    // the steps are bounded by max_steps for the full circle
+    auto min_step = static_cast<std::float_t>(2.0 * M_PI / std::max<std::size_t>(options.max_steps, 4));
 
-        // helpers
-        auto dot = dL.dot(dR);
-        auto alpha = std::acos(dot) / 2.0f; // angle from left part to "normal" on bisection
-        auto cross = dL[0] * dR[1] - dL[1] * dR[0]; // to check orientation
+    // the whole arc is within the tolerance
+    if (!(screen_radius > options.tolerance)) return M_PI;
 
-        if (cross < 0) alpha = -alpha; // change alpha so we always have thecorrect orientation
+    // the chord is within the tolerance when r * (1 - cos(step / 2)) <= tolerance
+    auto step = 2.0f * std::acos(1.0f - options.tolerance / screen_radius);
 
-        // set the bisection vector
-        mff::Vector2f bisec;
-        if (std::cos(alpha) > 0.1f) {
-            // if alpha not too small we can use
-            bisec = get_perpendicular((dL + dR).normalized()) * (half_width / std::cos(alpha));
-        } else {
-            // TODO: check if we can use this everytime
-            std::float_t sign = cross < 0 ? 1.0f : -1.0f;
-            bisec = (mff::lerp(p0 + sign * dLp * half_width, p0 + sign * dRp * half_width, 0.5f)) - p0;
-        }
+    return std::clamp<std::float_t>(step, min_step, M_PI);
+}
 
-        // first index
-        auto curr_vertices_ix = result_vertices.size();
+/**
+ * Split the arc of sweep to the same steps (at most max_step)
+ */
+std::float_t get_arc_step(std::float_t sweep, std::float_t max_step) {
+    auto steps = std::max(1.0f, std::ceil(std::abs(sweep) / max_step - 1e-4f));
 
-        // check whether miter is incorrect to use (miter limit)
-        auto join_to_use = std::visit(
-            mff::overloaded{
-                [&](const LineJoin_::Miter& m) -> LineJoin {
-                    if ((half_width / std::cos(alpha)) > m.value) {
-                        return LineJoin_::Bevel{};
-                    }
+    return std::abs(sweep) / steps;
+}
 
-                    return m;
-                },
-                [](const auto& other) -> LineJoin { return other; }
-            }, style.line_join
-        );
+}
 
-        // add joins (order dependent on curve orientation)
-        std::visit(
-            mff::overloaded{
-                [&](const LineJoin_::Bevel b) {
-                    if (cross < 0) {
-                        add_vert(p0 + bisec);
-                        add_vert(p0 - (dLp * half_width));
-                        add_vert(p0 - (dRp * half_width));
-
-                        add_indices_triangle(curr_vertices_ix, curr_vertices_ix + 2, curr_vertices_ix + 1);
-                        add_indices_triangle(curr_vertices_ix + 2, curr_vertices_ix + 4, curr_vertices_ix);
-                        add_indices_triangle(curr_vertices_ix, curr_vertices_ix + 3, curr_vertices_ix + 4);
-                    } else {
-                        add_vert(p0 + (dLp * half_width));
-                        add_vert(p0 - bisec);
-                        add_vert(p0 + (dRp * half_width));
-
-                        add_indices_triangle(curr_vertices_ix, curr_vertices_ix + 2, curr_vertices_ix + 1);
-                        add_indices_triangle(curr_vertices_ix + 2, curr_vertices_ix + 3, curr_vertices_ix + 1);
-                        add_indices_triangle(curr_vertices_ix + 1, curr_vertices_ix + 3, curr_vertices_ix + 4);
-                    }
-                },
-                [&](const LineJoin_::Miter m) {
-                    add_vert(p0 + bisec);
-                    add_vert(p0 - bisec);
-                    add_indices_rectangle(curr_vertices_ix);
-                },
-                [&](const LineJoin_::Round r) {
-                    std::float_t step = M_PI / (5 * half_width);
-                    std::float_t beta = std::acos(dLp[0]); // angle of left normal
-                    if (dLp[1] < 0.0f) beta = -beta;
+std::vector<Contour> stroke(const Contour& to_stroke, const StrokeStyle& style, const FlattenOptions& options) {
+    auto half_width = style.line_width / 2.0f;
 
-                    if (cross < 0) {
-                        // add end of current segment
-                        add_vert(p0 + bisec);
-                        add_vert(p0 - (dLp * half_width));
+    if (to_stroke.empty() || !(half_width > 0.0f)) return {};
 
-                        beta += M_PI; // we are adding the "bottom" part
-                        std::float_t beta_to = beta + alpha * 2;
-                        beta -= step;
+    // the segments which have some direction (zero length segments do not change the stroke)
+    std::vector<Segment> segments;
 
-                        while (beta > beta_to) {
-                            add_vert({std::cos(beta) * half_width + p0[0], std::sin(beta) * half_width + p0[1]});
-                            beta -= step;
-                        }
+    for (const auto& segment: to_stroke.segment_view()) {
+        if (get_start_direction(segment)) segments.push_back(simplify_segment(segment));
+    }
 
-                        std::uint32_t after_add_vertices_ix = result_vertices.size();
+    std::vector<Contour> result;
 
-                        add_indices_triangle(curr_vertices_ix, curr_vertices_ix + 2, curr_vertices_ix + 1);
+    if (segments.empty()) {
+        // zero length path is painted only by the caps (as a dot)
+        if (std::holds_alternative<LineCap_::Butt>(style.line_cap)) return {};
 
-                        for (std::uint32_t indice = curr_vertices_ix + 2; indice < after_add_vertices_ix; indice++) {
-                            add_indices_triangle(indice, indice + 1, curr_vertices_ix);
-                        }
+        Contour dot;
+        append_cap(dot, to_stroke.points.front(), {1.0f, 0.0f}, half_width, style.line_cap);
+        append_cap(dot, to_stroke.points.front(), {-1.0f, 0.0f}, half_width, style.line_cap);
+        close_contour(dot);
 
-                        add_indices_triangle(after_add_vertices_ix, after_add_vertices_ix + 2, curr_vertices_ix);
-                        add_indices_triangle(curr_vertices_ix, after_add_vertices_ix + 1, after_add_vertices_ix + 2);
+        result.push_back(std::move(dot));
 
-                        add_vert(p0 - (dRp * half_width));
-                    } else {
-                        // add end of current segment
-                        add_vert(p0 + (dLp * half_width));
-                        add_vert(p0 - bisec);
+        return result;
+    }
 
-                        std::float_t beta_to = beta + alpha * 2;
-                        beta += step;
+    // the right side is the left side of the reversed segments
+    std::vector<Segment> reversed;
+    reversed.reserve(segments.size());
 
-                        while (beta < beta_to) {
-                            add_vert({std::cos(beta) * half_width + p0[0], std::sin(beta) * half_width + p0[1]});
-                            beta += step;
-                        }
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        reversed.push_back(it->reversed());
+    }
 
-                        std::uint32_t after_add_vertices_ix = result_vertices.size();
+    if (to_stroke.closed) {
+        Contour outer;
+        append_side(outer, segments, half_width, style, options, true);
+        close_contour(outer);
 
-                        add_indices_triangle(curr_vertices_ix, curr_vertices_ix + 2, curr_vertices_ix + 1);
+        Contour inner;
+        append_side(inner, reversed, half_width, style, options, true);
+        close_contour(inner);
 
-                        for (std::uint32_t indice = curr_vertices_ix + 2; indice < after_add_vertices_ix; indice++) {
-                            add_indices_triangle(indice, indice + 1, curr_vertices_ix + 1);
-                        }
+        result.push_back(std::move(outer));
+        result.push_back(std::move(inner));
 
-                        add_indices_triangle(after_add_vertices_ix, after_add_vertices_ix + 1, curr_vertices_ix + 1);
-                        add_indices_triangle(
-                            curr_vertices_ix + 1,
-                            after_add_vertices_ix + 1,
-                            after_add_vertices_ix + 2
-                        );
+        return result;
+    }
 
-                        add_vert(p0 + (dRp * half_width));
-                    }
-                },
-            },
-            join_to_use
-        );
+    Contour outline;
+    append_side(outline, segments, half_width, style, options, false);
+    append_cap(
+        outline,
+        segments.back().get_baseline().to,
+        get_end_direction(segments.back()).value(),
+        half_width,
+        style.line_cap);
+    append_side(outline, reversed, half_width, style, options, false);
+    append_cap(
+        outline,
+        reversed.back().get_baseline().to,
+        get_end_direction(reversed.back()).value(),
+        half_width,
+        style.line_cap);
+    close_contour(outline);
+
+    result.push_back(std::move(outline));
+
+    return result;
+}
 
-        return cross;
-    };
+void append_stroke(
+    StrokeResult& result,
+    const std::vector<mff::Vector2f>& flattened,
+    const StrokeStyle& style,
+    bool loop,
+    const FlattenOptions& options,
+    StrokeTopology topology
+) {
+    auto half_width = style.line_width / 2.0f;
+
+    if (!(half_width > 0.0f)) return;
 
+    // the repeated points do not have any direction (so they are skipped)
+    std::vector<mff::Vector2f> points;
+    points.reserve(flattened.size());
+
+    for (const auto& point: flattened) {
+        if (points.empty() || !mff::are_approx_same(points.back(), point)) points.push_back(point);
+    }
 
-    auto pL = get_point(-1);
-    auto p0 = get_point(0);
-    auto pR = get_point(1);
+    if (loop && points.size() > 1 && mff::are_approx_same(points.front(), points.back())) points.pop_back();
 
-    std::size_t start = 0;
-    std::size_t end = flattened.size();
+    if (points.size() < 2) return;
 
-    if (!loop) {
-        start = 1;
-        end = flattened.size() - 1;
+    // the directions and lengths of lines (the last one closes the loop)
+    auto lines_count = loop ? points.size() : points.size() - 1;
+    std::vector<mff::Vector2f> directions;
+    std::vector<std::float_t> lengths;
+    directions.reserve(lines_count);
+    lengths.reserve(lines_count);
 
-        add_cap(flattened[0], flattened[1], true);
+    for (std::size_t i = 0; i < lines_count; i++) {
+        mff::Vector2f line = points[(i + 1) % points.size()] - points[i];
 
-        pL = p0;
-        p0 = pR;
-        pR = get_point(2);
+        lengths.push_back(line.norm());
+        directions.push_back(line / lengths.back());
     }
 
-    for (auto i = start; i < end; ++i) {
-        if (mff::are_approx_same(p0, pL) || mff::are_approx_same(p0, pR)) {
-            p0 = pR;
-            pR = get_point(i + 2);
+    // the round caps and joins are within the tolerance in screen space
+    auto max_arc_step = get_max_arc_step(half_width, options);
+
+    // the strip consists of pairs of vertices (left and right side of stroke), every two
+    // consecutive pairs form a quad - the caps and joins are fans around one of the vertices of
+    // pair (it is repeated, so the strip contains degenerate triangles)
+    std::vector<std::uint32_t> strip;
+    strip.reserve(points.size() * 4);
+
+    auto add_vertex = [&](const mff::Vector2f& vertex) {
+        result.vertices.push_back(vertex);
+
+        return static_cast<std::uint32_t>(result.vertices.size() - 1);
+    };
+
+    auto add_pair = [&](std::uint32_t left, std::uint32_t right) {
+        strip.push_back(left);
+        strip.push_back(right);
+    };
+
+    // add the points of arc around center (without its end points)
+    auto add_arc = [&](
+        std::vector<std::uint32_t>& arc,
+        const mff::Vector2f& center,
+        std::float_t from_angle,
+        std::float_t sweep
+    ) {
+        auto step = get_arc_step(sweep, max_arc_step);
+        auto steps = static_cast<std::size_t>(std::round(std::abs(sweep) / step));
+
+        for (std::size_t i = 1; i < steps; i++) {
+            auto angle = from_angle + std::copysign(step * i, sweep);
+
+            arc.push_back(add_vertex(center + mff::Vector2f{std::cos(angle), std::sin(angle)} * half_width));
+        }
+    };
+
+    std::vector<std::uint32_t> fan;
+
+    auto add_start_cap = [&](const mff::Vector2f& point, const mff::Vector2f& direction) {
+        mff::Vector2f normal = get_left_normal(direction) * half_width;
+        mff::Vector2f base = point;
+
+        // if square cap move start point back
+        if (std::holds_alternative<LineCap_::Square>(style.line_cap)) base = point - direction * half_width;
+
+        auto left = add_vertex(base + normal);
+        auto right = add_vertex(base - normal);
+
+        if (std::holds_alternative<LineCap_::Round>(style.line_cap)) {
+            // half circle from the left side around the start point (fan around the right side)
+            fan.clear();
+            add_arc(fan, point, std::atan2(normal[1], normal[0]), M_PI);
+
+            for (auto it = fan.rbegin(); it != fan.rend(); ++it) add_pair(*it, right);
         }
 
-        add_step(pL, p0, pR);
+        add_pair(left, right);
+    };
 
-        pL = p0;
-        p0 = pR;
-        pR = get_point(i + 2);
-    }
+    auto add_end_cap = [&](const mff::Vector2f& point, const mff::Vector2f& direction) {
+        mff::Vector2f normal = get_left_normal(direction) * half_width;
+        mff::Vector2f base = point;
+
+        // if square cap move end point forward
+        if (std::holds_alternative<LineCap_::Square>(style.line_cap)) base = point + direction * half_width;
+
+        auto left = add_vertex(base + normal);
+        auto right = add_vertex(base - normal);
+
+        add_pair(left, right);
+
+        if (std::holds_alternative<LineCap_::Round>(style.line_cap)) {
+            // half circle from the right side around the end point (fan around the left side)
+            fan.clear();
+            add_arc(fan, point, std::atan2(-normal[1], -normal[0]), M_PI);
+
+            for (auto vertex: fan) add_pair(left, vertex);
+        }
+    };
+
+    auto add_join = [&](
+        const mff::Vector2f& point,
+        const mff::Vector2f& incoming,
+        const mff::Vector2f& outgoing,
+        std::float_t shorter_length
+    ) {
+        auto normal_in = get_left_normal(incoming);
+        auto normal_out = get_left_normal(outgoing);
+        auto dot = incoming.dot(outgoing);
+        auto turn = std::atan2(incoming[0] * outgoing[1] - incoming[1] * outgoing[0], dot);
+
+        // the offset lines of both sides intersect within the half of the shorter line
+        bool intersect = std::abs(turn) < 0.99f * M_PI
+            && half_width * std::tan(std::abs(turn) / 2.0f) <= shorter_length / 2.0f;
+        mff::Vector2f miter = mff::Vector2f::Zero();
+
+        if (intersect) miter = (normal_in + normal_out) * (half_width / (1.0f + dot));
+
+        // the miter over limit is replaced by bevel (the ratio of miter length and stroke width is
+        // 1 / cos(turn / 2))
+        LineJoin join = style.line_join;
 
-    if (!loop) {
-        add_cap(get_point(-1), get_point(-2), false);
+        auto miter_join = std::get_if<LineJoin_::Miter>(&join);
+
+        if (miter_join && std::cos(turn / 2.0f) * miter_join->value < 1.0f) join = LineJoin_::Bevel{};
+
+        // the sides share one pair when the join is (within the tolerance) the intersection of sides
+        bool shared = intersect && std::visit(
+            mff::overloaded{
+                [](const LineJoin_::Miter&) { return true; },
+                [&](const LineJoin_::Bevel&) { return std::abs(turn) * M_SQRT2 <= max_arc_step; },
+                [&](const LineJoin_::Round&) { return std::abs(turn) <= max_arc_step; }
+            },
+            join);
+
+        if (shared) {
+            add_pair(add_vertex(point + miter), add_vertex(point - miter));
+            return;
+        }
+
+        // turning right (clockwise) - the outer side is the left one
+        std::float_t outer_sign = turn < 0.0f ? 1.0f : -1.0f;
+        auto add_outer_pair = [&](std::uint32_t outer, std::uint32_t inner) {
+            if (outer_sign > 0.0f) {
+                add_pair(outer, inner);
+            } else {
+                add_pair(inner, outer);
+            }
+        };
+
+        // the outer side of join from the end of incoming line to the start of outgoing line
+        fan.clear();
+        fan.push_back(add_vertex(point + normal_in * (half_width * outer_sign)));
+
+        std::visit(
+            mff::overloaded{
+                [&](const LineJoin_::Miter&) {
+                    fan.push_back(add_vertex(point + miter * outer_sign));
+                },
+                [&](const LineJoin_::Bevel&) {},
+                [&](const LineJoin_::Round&) {
+                    mff::Vector2f from = normal_in * outer_sign;
+                    add_arc(fan, point, std::atan2(from[1], from[0]), turn);
+                }
+            },
+            join);
+
+        fan.push_back(add_vertex(point + normal_out * (half_width * outer_sign)));
+
+        if (intersect) {
+            // fan around the intersection of the inner sides
+            auto inner = add_vertex(point - miter * outer_sign);
+            for (auto outer: fan) add_outer_pair(outer, inner);
+
+            return;
+        }
+
+        // the inner sides overlap too much - the lines end at the point and the join is fan
+        // around it
+        auto center = add_vertex(point);
+
+        add_outer_pair(fan.front(), add_vertex(point - normal_in * (half_width * outer_sign)));
+        for (auto outer: fan) add_outer_pair(outer, center);
+        add_outer_pair(fan.back(), add_vertex(point - normal_out * (half_width * outer_sign)));
+    };
+
+    if (loop) {
+        for (std::size_t i = 0; i < points.size(); i++) {
+            auto previous = (i + lines_count - 1) % lines_count;
+
+            add_join(points[i], directions[previous], directions[i], std::min(lengths[previous], lengths[i]));
+        }
+
+        // the last line ends by the first pair
+        add_pair(strip[0], strip[1]);
     } else {
-        auto c = add_step(get_point(-2), get_point(-1), get_point(0));
-        auto bi = result_indices.size() - 6;
-
-        if (c < 0 && !std::holds_alternative<LineJoin_::Miter>(style.line_join)) {
-            result_indices[bi + 1] = 1;
-            result_indices[bi + 4] = 1;
-            result_indices[bi + 5] = 0;
-        } else {
-            result_indices[bi + 1] = 0;
-            result_indices[bi + 4] = 0;
-            result_indices[bi + 5] = 1;
+        add_start_cap(points.front(), directions.front());
+
+        for (std::size_t i = 1; i + 1 < points.size(); i++) {
+            add_join(points[i], directions[i - 1], directions[i], std::min(lengths[i - 1], lengths[i]));
         }
+
+        add_end_cap(points.back(), directions.back());
+    }
+
+    if (topology == StrokeTopology::TriangleStrip) {
+        if (!result.indices.empty()) result.indices.push_back(kSTROKE_RESTART_INDEX);
+
+        result.indices.insert(std::end(result.indices), std::begin(strip), std::end(strip));
+        return;
     }
 
-    return {result_vertices, result_indices};
+    // every three consecutive indices of strip are triangle (without the degenerate ones)
+    result.indices.reserve(result.indices.size() + strip.size() * 3);
+
+    for (std::size_t i = 0; i + 2 < strip.size(); i++) {
+        if (strip[i] == strip[i + 1] || strip[i + 1] == strip[i + 2] || strip[i] == strip[i + 2]) continue;
+
+        result.indices.push_back(strip[i]);
+        result.indices.push_back(strip[i + 1]);
+        result.indices.push_back(strip[i + 2]);
+    }
 }
 
+StrokeResult get_stroke(
+    const std::vector<mff::Vector2f>& flattened,
+    const StrokeStyle& style,
+    bool loop,
+    const FlattenOptions& options,
+    StrokeTopology topology
+) {
+    StrokeResult result;
+    append_stroke(result, flattened, style, loop, options, topology);
+
+    return result;
+}
 
 }
@@ -32,20 +32,72 @@ struct StrokeStyle {
     LineJoin line_join = LineJoin_::Bevel{};
 };
 
-std::vector<Contour> stroke(const Contour& to_stroke, const StrokeStyle& style);
+/**
+ * Stroke the contour directly (without flattening it) - every segment is offset to both sides and
+ * the offset segments are connected by the joins and caps (round ones are circular arcs). The
+ * result is the outline of the stroke which has to be filled by nonzero fill rule (one closed
+ * contour for open contour, outer and inner contour for closed one).
+ *
+ * The offset curves are split until they are within the tolerance of options (in screen space), so
+ * the outline can be flattened with the same options and it stays precise at any scale.
+ * @param to_stroke
+ * @param style
+ * @param options the tolerance of the offset curves
+ * @return contours of the stroke outline
+ */
+std::vector<Contour> stroke(const Contour& to_stroke, const StrokeStyle& style, const FlattenOptions& options = {});
+
+/**
+ * How are the triangles of stroke described by indices
+ */
+enum class StrokeTopology {
+    // every three indices are one triangle
+    TriangleList,
+    // the indices are triangle strip (the strips of contours are separated by kSTROKE_RESTART_INDEX)
+    TriangleStrip
+};
+
+// the index which restarts the triangle strip (primitive restart of 32 bit indices)
+const std::uint32_t kSTROKE_RESTART_INDEX = 0xFFFFFFFF;
 
 struct StrokeResult {
     std::vector<mff::Vector2f> vertices;
     std::vector<std::uint32_t> indices;
 };
 
+/**
+ * Append the stroke of flattened curve to the result. The adjacent quads of the stroke share their
+ * vertices (one pair of vertices per point, where the sides meet), the joins and caps are fans
+ * around one of the vertices of pair.
+ * @param result
+ * @param flattened
+ * @param style
+ * @param loop
+ * @param options the round joins and caps are split to lines within the tolerance (in screen space)
+ * @param topology
+ */
+void append_stroke(
+    StrokeResult& result,
+    const std::vector<mff::Vector2f>& flattened,
+    const StrokeStyle& style,
+    bool loop = false,
+    const FlattenOptions& options = {},
+    StrokeTopology topology = StrokeTopology::TriangleStrip);
+
 /**
  * Get the final shape of stroke for flattened curve
  * @param flattened
  * @param style
  * @param loop
+ * @param options the round joins and caps are split to lines within the tolerance (in screen space)
+ * @param topology
  * @return
  */
-StrokeResult get_stroke(const std::vector<mff::Vector2f>& flattened, const StrokeStyle& style, bool loop = false);
+StrokeResult get_stroke(
+    const std::vector<mff::Vector2f>& flattened,
+    const StrokeStyle& style,
+    bool loop = false,
+    const FlattenOptions& options = {},
+    StrokeTopology topology = StrokeTopology::TriangleStrip);
 
-}
\ No newline at end of file
+}
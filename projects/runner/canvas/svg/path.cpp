@@ -21,72 +21,26 @@ bool is_path_digit(char c) {
 
 using Parser = mff::parser_combinator::parsers::Parsers<std::string_view>;
 
-/////////////////////
-/// Parse numbers ///
-/////////////////////
+// The intermediate parsers keep their own (statically composed) types - there is no type erasure
+// in the grammars (typed only checks the output type), so the whole parser can be inlined.
+// The numbers are parsed directly from the input (float_p) without any temporary strings.
 
-
-struct recognize_float {
-    auto operator()(const std::string_view& input) const {
-        using parsers = Parser;
-
-        return parsers::recognize(
-            parsers::tuple(
-                // there is optional sign
-                parsers::opt(parsers::alt(parsers::complete::char_p('+'), parsers::complete::char_p('-'))),
-                // then there are two options
-                parsers::alt(
-                    // either the number starts with number and follows with optional decimal part
-                    parsers::ignore(
-                        parsers::tuple(
-                            parsers::complete::digit1,
-                            parsers::opt(
-                                parsers::pair(
-                                    parsers::complete::char_p('.'),
-                                    parsers::opt(parsers::complete::digit1))))),
-                    // or we get dot followed by digits (.001)
-                    parsers::ignore(
-                        parsers::tuple(
-                            parsers::complete::char_p('.'),
-                            parsers::complete::digit1
-                        )
-                    )
-                )
-            )
-        )(input);
-    }
-};
-
-struct parse_float {
-    auto operator()(const std::string_view& input) const {
-        using parsers = Parser;
-
-        return parsers::map(
-            recognize_float{},
-            [](const auto& number) {
-                return std::stof(std::string(number));
-            }
-        )(input);
-    }
-};
-
-
-template <typename Output>
-using parser_fn = std::function<mff::parser_combinator::ParserResult<std::string_view, Output>(const std::string_view&)>;
-
-using ignore_parser_fn = parser_fn<mff::parser_combinator::parsers::combinator::Ignore>;
 ///////////////////////
 /// Command parsers ///
 ///////////////////////
 
-auto parse_coordinates_internal(const std::string_view& input) {
+/**
+ * Build parser of coordinates sequence (used by polygon and polyline points)
+ * @return
+ */
+auto build_coordinates_parser() {
     using parsers = Parser;
-    ignore_parser_fn parse_space = parsers::ignore(parsers::complete::take_while1(is_path_space));
-    ignore_parser_fn parse_space_optional = parsers::ignore(parsers::complete::take_while(is_path_space));
-    ignore_parser_fn parse_comma_symbol = parsers::ignore(parsers::complete::char_p(','));
+    auto parse_space = parsers::ignore(parsers::complete::take_while1(is_path_space));
+    auto parse_space_optional = parsers::ignore(parsers::complete::take_while(is_path_space));
+    auto parse_comma_symbol = parsers::ignore(parsers::complete::char_p(','));
 
     // space or comma with some space
-    ignore_parser_fn parse_comma_separator = parsers::ignore(
+    auto parse_comma_separator = parsers::ignore(
         parsers::tuple(
             parsers::alt(
                 // required space and optional comma
@@ -97,7 +51,7 @@ auto parse_coordinates_internal(const std::string_view& input) {
             // optional following space
             parse_space_optional
         ));
-    ignore_parser_fn parse_comma_separator_optional = parsers::ignore(parsers::opt(parse_comma_separator));
+    auto parse_comma_separator_optional = parsers::ignore(parsers::opt(parse_comma_separator));
 
     // factory which indicates that specified parser should be preceded by comma or space
     auto preceded_with_comma = [&](const auto& parser) {
@@ -105,22 +59,25 @@ auto parse_coordinates_internal(const std::string_view& input) {
     };
 
     // number parser
-    parser_fn<std::float_t> parse_number = parse_float{};
+    auto parse_number = parsers::complete::float_p;
 
     // two numbers with separators between them
-    parser_fn<mff::Vector2f> parse_coordinate = parsers::map(
+    auto parse_coordinate = parsers::typed<mff::Vector2f>(parsers::map(
         parsers::pair(parse_number, preceded_with_comma(parse_number)),
         [](auto i) -> mff::Vector2f { return {i.first, i.second}; }
-    );
-    parser_fn<std::vector<mff::Vector2f>> parse_coordinate_sequence = parsers::many1(
+    ));
+    auto parse_coordinate_sequence = parsers::typed<std::vector<mff::Vector2f>>(parsers::many1(
         preceded_with_comma(
             parse_coordinate
-        ));
+        )));
 
-    return parse_coordinate_sequence(input);
+    return parse_coordinate_sequence;
 }
 
-boost::leaf::result<std::vector<mff::Vector2f>> parse_coordinates(const std::string& input) {
+boost::leaf::result<std::vector<mff::Vector2f>> parse_coordinates(std::string_view input) {
+    // the grammar is built only once (the parsers are stateless, so it can be shared by threads)
+    static const auto parse_coordinates_internal = build_coordinates_parser();
+
     auto result = parse_coordinates_internal(input);
 
     if (!result)
@@ -129,16 +86,20 @@ boost::leaf::result<std::vector<mff::Vector2f>> parse_coordinates(const std::str
     return std::move(result->output);
 }
 
-auto parse_path_internal(const std::string_view& input) {
+/**
+ * Build parser of path data (the "d" attribute)
+ * @return
+ */
+auto build_path_parser() {
     using parsers = Parser;
 
     // at least one space
-    ignore_parser_fn parse_space = parsers::ignore(parsers::complete::take_while1(is_path_space));
-    ignore_parser_fn parse_space_optional = parsers::ignore(parsers::complete::take_while(is_path_space));
-    ignore_parser_fn parse_comma_symbol = parsers::ignore(parsers::complete::char_p(','));
+    auto parse_space = parsers::ignore(parsers::complete::take_while1(is_path_space));
+    auto parse_space_optional = parsers::ignore(parsers::complete::take_while(is_path_space));
+    auto parse_comma_symbol = parsers::ignore(parsers::complete::char_p(','));
 
     // space or comma with some space
-    ignore_parser_fn parse_comma_separator = parsers::ignore(
+    auto parse_comma_separator = parsers::ignore(
         parsers::tuple(
             parsers::alt(
                 // required space and optional comma
@@ -149,7 +110,7 @@ auto parse_path_internal(const std::string_view& input) {
             // optional following space
             parse_space_optional
         ));
-    ignore_parser_fn parse_comma_separator_optional = parsers::ignore(parsers::opt(parse_comma_separator));
+    auto parse_comma_separator_optional = parsers::ignore(parsers::opt(parse_comma_separator));
 
     // factory which indicates that specified parser should be preceded by comma or space
     auto preceded_with_comma = [&](const auto& parser) {
@@ -157,42 +118,42 @@ auto parse_path_internal(const std::string_view& input) {
     };
 
     // number parser
-    parser_fn<std::float_t> parse_number = parse_float{};
-    parser_fn<std::vector<std::float_t>> parse_number_sequence = parsers::many1(preceded_with_comma(parse_number));
+    auto parse_number = parsers::complete::float_p;
+    auto parse_number_sequence = parsers::typed<std::vector<std::float_t>>(parsers::many1(preceded_with_comma(parse_number)));
 
     // two numbers with separators between them
-    parser_fn<mff::Vector2f> parse_coordinate = parsers::map(
+    auto parse_coordinate = parsers::typed<mff::Vector2f>(parsers::map(
         parsers::pair(parse_number, preceded_with_comma(parse_number)),
         [](auto i) -> mff::Vector2f { return {i.first, i.second}; }
-    );
-    parser_fn<std::vector<mff::Vector2f>> parse_coordinate_sequence = parsers::many1(
+    ));
+    auto parse_coordinate_sequence = parsers::typed<std::vector<mff::Vector2f>>(parsers::many1(
         preceded_with_comma(
             parse_coordinate
-        ));
+        )));
 
     // two coordinates with separators between them
-    parser_fn<std::tuple<mff::Vector2f, mff::Vector2f>> parse_coordinate_double = parsers::tuple(
+    auto parse_coordinate_double = parsers::typed<std::tuple<mff::Vector2f, mff::Vector2f>>(parsers::tuple(
         parse_coordinate,
-        preceded_with_comma(parse_coordinate));
-    parser_fn<std::vector<std::tuple<mff::Vector2f, mff::Vector2f>>> parse_coordinate_double_sequence = parsers::many1(
-        preceded_with_comma(parse_coordinate_double));
+        preceded_with_comma(parse_coordinate)));
+    auto parse_coordinate_double_sequence = parsers::typed<std::vector<std::tuple<mff::Vector2f, mff::Vector2f>>>(parsers::many1(
+        preceded_with_comma(parse_coordinate_double)));
 
     // three coordinates with spaces between them
-    parser_fn<std::tuple<mff::Vector2f, mff::Vector2f, mff::Vector2f>> parse_coordinate_triplet = parsers::tuple(
+    auto parse_coordinate_triplet = parsers::typed<std::tuple<mff::Vector2f, mff::Vector2f, mff::Vector2f>>(parsers::tuple(
         parse_coordinate,
         preceded_with_comma(parse_coordinate),
         preceded_with_comma(parse_coordinate)
-    );
-    parser_fn<std::vector<std::tuple<mff::Vector2f, mff::Vector2f, mff::Vector2f>>> parse_coordinate_triplet_sequence = parsers::many1(
-        preceded_with_comma(parse_coordinate_triplet));
+    ));
+    auto parse_coordinate_triplet_sequence = parsers::typed<std::vector<std::tuple<mff::Vector2f, mff::Vector2f, mff::Vector2f>>>(parsers::many1(
+        preceded_with_comma(parse_coordinate_triplet)));
 
     // Create parser which will parse the specified symbol - if it is upper case we should use
     // absolute positioning and if it is lower case we should use relative positioning
-    auto command_position_parser = [&](char symbol) -> parser_fn<Position> {
-        return parsers::alt(
+    auto command_position_parser = [&](char symbol) {
+        return parsers::typed<Position>(parsers::alt(
             parsers::value(Position::Absolute, parsers::complete::char_p(std::toupper(symbol))),
             parsers::value(Position::Relative, parsers::complete::char_p(std::tolower(symbol)))
-        );
+        ));
     };
 
     // Create parser which will start with symbol (which indicates positioning) followed by
@@ -210,58 +171,58 @@ auto parse_path_internal(const std::string_view& input) {
     };
 
     // Parse moveto command "M" followed by coordinates
-    parser_fn<Command> parse_moveto = parsers::map(
+    auto parse_moveto = parsers::typed<Command>(parsers::map(
         command_with_sequence_parser('M', parse_coordinate_sequence),
         [](const auto& i) -> Command {
             return Commands_::Moveto{std::get<0>(i), std::get<1>(i)};
         }
-    );
+    ));
 
     // Parse closepath command "Z"
-    parser_fn<Command> parse_closepath = parsers::value(Command{Commands_::Closepath{}}, command_position_parser('Z'));
+    auto parse_closepath = parsers::typed<Command>(parsers::value(Command{Commands_::Closepath{}}, command_position_parser('Z')));
 
     // Parse lineto command "L" followed by coordinates
-    parser_fn<Command> parse_lineto = parsers::map(
+    auto parse_lineto = parsers::typed<Command>(parsers::map(
         command_with_sequence_parser('L', parse_coordinate_sequence),
         [](const auto& i) -> Command {
             return Commands_::Lineto{std::get<0>(i), std::get<1>(i)};
         }
-    );
+    ));
 
     // Parse horizontal lineto command "H" followed by numbers
-    parser_fn<Command> parse_horizontal_lineto = parsers::map(
+    auto parse_horizontal_lineto = parsers::typed<Command>(parsers::map(
         command_with_sequence_parser('H', parse_number_sequence),
         [](const auto& i) -> Command {
             return Commands_::HorizontalLineto{std::get<0>(i), std::get<1>(i)};
         }
-    );
+    ));
 
     // Parse vertical lineto command "v" followed by numbers
-    parser_fn<Command> parse_vertical_lineto = parsers::map(
+    auto parse_vertical_lineto = parsers::typed<Command>(parsers::map(
         command_with_sequence_parser('V', parse_number_sequence),
         [](const auto& i) -> Command {
             return Commands_::VerticalLineto{std::get<0>(i), std::get<1>(i)};
         }
-    );
+    ));
 
     // Parse curveto command "C" followed by coordinates triplets (C1 C2 P)
-    parser_fn<Command> parse_curveto = parsers::map(
+    auto parse_curveto = parsers::typed<Command>(parsers::map(
         command_with_sequence_parser('C', parse_coordinate_triplet_sequence),
         [](const auto& i) -> Command {
             return Commands_::Curveto{std::get<0>(i), std::get<1>(i)};
         }
-    );
+    ));
 
     // Parse smooth curveto command "C" followed by coordinates doubles (C1 P)
-    parser_fn<Command> parse_smooth_curveto = parsers::map(
+    auto parse_smooth_curveto = parsers::typed<Command>(parsers::map(
         command_with_sequence_parser('S', parse_coordinate_double_sequence),
         [](const auto& i) -> Command {
             return Commands_::SmoothCurveto{std::get<0>(i), std::get<1>(i)};
         }
-    );
+    ));
 
     // Commands parser
-    parser_fn<Command> parse_command = parsers::alt(
+    auto parse_command = parsers::typed<Command>(parsers::alt(
         parse_lineto,
         parse_closepath,
         parse_horizontal_lineto,
@@ -269,12 +230,12 @@ auto parse_path_internal(const std::string_view& input) {
         parse_curveto,
         parse_smooth_curveto,
         parse_moveto
-    );
+    ));
 
-    parser_fn<std::tuple<Command, std::vector<Command>>> parse_first_then_rest = parsers::tuple(
+    auto parse_first_then_rest = parsers::typed<std::tuple<Command, std::vector<Command>>>(parsers::tuple(
         parsers::preceded(parse_space_optional, parse_moveto),
         parsers::many0(parsers::preceded(parse_space_optional, parse_command))
-    );
+    ));
 
     return parsers::map(
         parse_first_then_rest,
@@ -285,11 +246,14 @@ auto parse_path_internal(const std::string_view& input) {
 
             return rest;
         }
-    )(input);
+    );
 }
 
 //template <typename Input, typename Error=mff::parser_combinator::error::DefaultError<Input>>
-boost::leaf::result<std::vector<Command>> parse_path(const std::string& input) {
+boost::leaf::result<std::vector<Command>> parse_path(std::string_view input) {
+    // the grammar is built only once (the parsers are stateless, so it can be shared by threads)
+    static const auto parse_path_internal = build_path_parser();
+
     auto result = parse_path_internal(input);
 
     if (!result)
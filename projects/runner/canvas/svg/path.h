@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -56,7 +57,7 @@ using Command = std::variant<
     Commands_::SmoothCurveto
 >;
 
-boost::leaf::result<std::vector<Command>> parse_path(const std::string& input);
-boost::leaf::result<std::vector<mff::Vector2f>> parse_coordinates(const std::string& input);
+boost::leaf::result<std::vector<Command>> parse_path(std::string_view input);
+boost::leaf::result<std::vector<mff::Vector2f>> parse_coordinates(std::string_view input);
 
 }
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include "./xml.h"
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <string_view>
 #include <stack>
+#include <stdexcept>
 
-#include <range/v3/all.hpp>
-#include <mff/algorithms.h>
 #include <mff/utils.h>
 #include <mff/parser_combinator/parsers.h>
 
@@ -14,12 +16,6 @@ namespace canvas::svg {
 
 using Parser = mff::parser_combinator::parsers::Parsers<std::string_view>;
 
-
-template <typename Output>
-using parser_fn = std::function<mff::parser_combinator::ParserResult<std::string_view, Output>(const std::string_view&)>;
-
-using ignore_parser_fn = parser_fn<mff::parser_combinator::parsers::combinator::Ignore>;
-
 bool is_xml_space(char c) {
     return c == 0x20 || c == 0x9 || c == 0xA || c == 0xD;
 }
@@ -50,14 +46,61 @@ bool is_name_char(char c) {
     return is_xml_letter(c) || is_xml_digit(c) || c == '.' || c == '-' || c == '_' || c == ':';
 }
 
-template <typename Input, typename Error = mff::parser_combinator::error::DefaultError<Input>>
-auto parse_xml_internal(const Input& input) {
+void XmlAttributes::add(std::string_view name, std::string_view value) {
+    for (auto& attribute: attributes_) {
+        if (attribute.first == name) {
+            attribute.second = value;
+            return;
+        }
+    }
+
+    attributes_.emplace_back(name, value);
+}
+
+bool XmlAttributes::has(std::string_view name) const {
+    return get(name).has_value();
+}
+
+std::optional<std::string_view> XmlAttributes::get(std::string_view name) const {
+    for (const auto& attribute: attributes_) {
+        if (attribute.first == name) return attribute.second;
+    }
+
+    return std::nullopt;
+}
+
+std::string_view XmlAttributes::at(std::string_view name) const {
+    auto value = get(name);
+
+    if (!value) throw std::out_of_range("There is no such attribute");
+
+    return *value;
+}
+
+XmlAttributes::Container::const_iterator XmlAttributes::begin() const {
+    return attributes_.begin();
+}
+
+XmlAttributes::Container::const_iterator XmlAttributes::end() const {
+    return attributes_.end();
+}
+
+std::size_t XmlAttributes::size() const {
+    return attributes_.size();
+}
+
+/**
+ * Build parser of one XML item (tag or character data)
+ * @return
+ */
+auto build_xml_parser() {
+    using Input = std::string_view;
     using parsers = Parser;
 
-    ignore_parser_fn parse_space = parsers::ignore(parsers::complete::take_while1(is_xml_space));
-    ignore_parser_fn parse_space_optional = parsers::ignore(parsers::complete::take_while(is_xml_space));
+    auto parse_space = parsers::ignore(parsers::complete::take_while1(is_xml_space));
+    auto parse_space_optional = parsers::ignore(parsers::complete::take_while(is_xml_space));
 
-    parser_fn<std::string_view> parse_name = parsers::recognize(
+    auto parse_name = parsers::typed<std::string_view>(parsers::recognize(
         parsers::tuple(
             parsers::verify(
                 parsers::complete::take(1),
@@ -67,136 +110,180 @@ auto parse_xml_internal(const Input& input) {
                 }
             ),
             parsers::complete::take_while(is_name_char)
-        ));
+        )));
 
-    ignore_parser_fn parse_eq = parsers::ignore(parsers::between(parse_space_optional, parsers::complete::char_p('=')));
+    auto parse_eq = parsers::ignore(parsers::between(parse_space_optional, parsers::complete::char_p('=')));
 
     auto is_not_char = [](char c) { return [c](const auto& i) -> bool { return c != i; }; };
-    auto any_surrounded_by = [&](char c) -> parser_fn<std::string_view> {
-        return parsers::between(
+    auto any_surrounded_by = [&](char c) {
+        return parsers::typed<std::string_view>(parsers::between(
             parsers::complete::char_p(c),
-            parsers::complete::take_while(is_not_char(c)));
+            parsers::complete::take_while(is_not_char(c))));
     };
 
-    parser_fn<std::string_view> parse_attribute_value = parsers::alt(any_surrounded_by('\''), any_surrounded_by('"'));
-    parser_fn<std::pair<std::string_view, std::string_view>> parse_attribute = parsers::separated_pair(
+    auto parse_attribute_value = parsers::typed<std::string_view>(parsers::alt(any_surrounded_by('\''), any_surrounded_by('"')));
+    auto parse_attribute = parsers::typed<std::pair<std::string_view, std::string_view>>(parsers::separated_pair(
         parse_name,
         parse_eq,
         parse_attribute_value
-    );
-    parser_fn<std::unordered_map<std::string, std::string>> parse_attributes = parsers::map(
-        parsers::many0(parsers::preceded(parse_space_optional, parse_attribute)),
-        [](const auto& attributes) {
-            std::unordered_map<std::string, std::string> result;
-
-            for (const auto& attribute: attributes) {
-                result[std::string(std::get<0>(attribute))] = std::string(std::get<1>(attribute));
-            }
-
-            return result;
+    ));
+    // the attributes are collected directly (they are pointing into the input)
+    auto parse_attributes = parsers::typed<XmlAttributes>(parsers::fold_many0(
+        parsers::preceded(parse_space_optional, parse_attribute),
+        []() { return XmlAttributes{}; },
+        [](XmlAttributes& attributes, const std::pair<std::string_view, std::string_view>& attribute) {
+            attributes.add(attribute.first, attribute.second);
         }
-    );
-    parser_fn<std::pair<std::string_view, std::unordered_map<std::string, std::string>>> parse_tag_content = parsers::terminated(
+    ));
+    auto parse_tag_content = parsers::typed<std::pair<std::string_view, XmlAttributes>>(parsers::terminated(
         parsers::pair(parse_name, parse_attributes),
         parse_space_optional
-    );
+    ));
     auto in_braces = [](Input start_brace, Input end_brace, auto parser) {
         return parsers::delimited(parsers::complete::tag(start_brace), parser, parsers::complete::tag(end_brace));
     };
 
-    parser_fn<XmlContent> parse_empty_element_tag = parsers::map(
+    auto parse_empty_element_tag = parsers::typed<XmlContent>(parsers::map(
         in_braces("<", "/>", parse_tag_content),
-        [](const auto& contents) -> XmlContent {
-            return XmlContent_::EmptyElementTag{std::string(std::get<0>(contents)), std::get<1>(contents)};
+        [](auto contents) -> XmlContent {
+            return XmlContent_::EmptyElementTag{contents.first, std::move(contents.second)};
         }
-    );
-    parser_fn<XmlContent> parse_start_element_tag = parsers::map(
+    ));
+    auto parse_start_element_tag = parsers::typed<XmlContent>(parsers::map(
         in_braces("<", ">", parse_tag_content),
-        [](const auto& contents) -> XmlContent {
-            return XmlContent_::StartTag{std::string(std::get<0>(contents)), std::get<1>(contents)};
+        [](auto contents) -> XmlContent {
+            return XmlContent_::StartTag{contents.first, std::move(contents.second)};
         }
-    );
-    parser_fn<XmlContent> parse_end_element_tag = parsers::map(
+    ));
+    auto parse_end_element_tag = parsers::typed<XmlContent>(parsers::map(
         in_braces("</", ">", parsers::terminated(parse_name, parse_space_optional)),
         [](const auto& name) -> XmlContent {
-            return XmlContent_::EndTag{std::string(name)};
+            return XmlContent_::EndTag{name};
         }
-    );
-    parser_fn<XmlContent> parse_xml_char_data = parsers::map(
+    ));
+    auto parse_xml_char_data = parsers::typed<XmlContent>(parsers::map(
         parsers::complete::take_while1([](auto c) { return c != '<' && c != '>'; }),
         [](const auto& data) -> XmlContent {
             return XmlContent_::CharData{};
         }
-    );
+    ));
 
-    parser_fn<XmlContent> parse_some = parsers::alt(
+    auto parse_some = parsers::typed<XmlContent>(parsers::alt(
         parse_empty_element_tag,
         parse_start_element_tag,
         parse_end_element_tag,
         parse_xml_char_data
-    );
+    ));
 
-    return parse_some(input);
+    return parse_some;
 }
 
-mff::Vector4f parse_color(const std::string& input) {
+/**
+ * Parse the next XML item (the grammar is built only once and shared by all threads - the
+ * parsers are stateless)
+ * @param input
+ * @return
+ */
+auto parse_xml_internal(const std::string_view& input) {
+    static const auto parse_xml = build_xml_parser();
+
+    return parse_xml(input);
+}
+
+/**
+ * Build parser of hex color (#rgb or #rrggbb)
+ * @return
+ */
+auto build_color_parser() {
     using parsers = Parser;
 
     auto is_hex_digit = [](char c) -> bool {
         return isxdigit(c);
     };
 
-    parser_fn<std::string_view> digits = parsers::verify(
+    auto digits = parsers::typed<std::string_view>(parsers::verify(
         parsers::complete::take_while(is_hex_digit),
         [](const auto& value) {
             return value.size() == 6 || value.size() == 3;
         }
-    );
+    ));
 
-    parser_fn<std::string_view> whole = parsers::preceded(parsers::complete::char_p('#'), digits);
+    auto whole = parsers::typed<std::string_view>(parsers::preceded(parsers::complete::char_p('#'), digits));
 
-    auto hex_to_num = [](const std::string& str, int from, int n = 2) -> std::float_t {
-        return (std::float_t) std::stoi(str.substr(from, n), 0, 16);
+    auto hex_to_num = [](std::string_view str, int from, int n = 2) -> std::float_t {
+        int value = 0;
+        std::from_chars(str.data() + from, str.data() + from + n, value, 16);
+
+        return (std::float_t) value;
     };
 
     return parsers::map(
         whole,
-        [&](const auto& value) {
+        [hex_to_num](const auto& value) -> mff::Vector4f {
             if (value.size() == 3) {
                 return mff::Vector4f{
-                    hex_to_num(std::string(value), 0, 1) / 15.0f,
-                    hex_to_num(std::string(value), 1, 1) / 15.0f,
-                    hex_to_num(std::string(value), 2, 1) / 15.0f,
+                    hex_to_num(value, 0, 1) / 15.0f,
+                    hex_to_num(value, 1, 1) / 15.0f,
+                    hex_to_num(value, 2, 1) / 15.0f,
                     1.0f};
             }
 
             return mff::Vector4f{
-                hex_to_num(std::string(value), 0) / 255.0f,
-                hex_to_num(std::string(value), 2) / 255.0f,
-                hex_to_num(std::string(value), 4) / 255.0f,
+                hex_to_num(value, 0) / 255.0f,
+                hex_to_num(value, 2) / 255.0f,
+                hex_to_num(value, 4) / 255.0f,
                 1.0f};
         }
-    )(input)->output;
+    );
 }
 
-std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
-    std::vector<std::tuple<Path2D, DrawState>> result;
+mff::Vector4f parse_color(std::string_view input) {
+    static const auto parse_color_internal = build_color_parser();
+
+    return parse_color_internal(input)->output;
+}
 
-    auto next_input = std::string_view(data);
-    auto parsed_result = parse_xml_internal<std::string_view>(next_input);
+/**
+ * Parse numeric attribute directly from its value (without allocations) - the leading whitespace
+ * is skipped and anything after the number (units) is ignored, the same as std::stof does
+ * @param input
+ * @return
+ */
+std::float_t parse_number(std::string_view input) {
+    while (!input.empty() && is_xml_space(input.front())) input.remove_prefix(1);
+
+    auto result = Parser::complete::float_p(input);
+
+    if (!result) throw std::invalid_argument("Attribute value is not a number");
+
+    return result->output;
+}
+
+void for_each_path(std::string_view data, const PathCallback& callback, const Path2D::allocator_type& allocator) {
+    for_each_path(data, callback, [&]() { return allocator; });
+}
+
+void for_each_path(std::string_view data, const PathCallback& callback, const PathAllocatorCallback& get_allocator) {
+    auto next_input = data;
+    auto parsed_result = parse_xml_internal(next_input);
 
     std::stack<DrawState> states;
     states.push(DrawState{});
 
-    auto to_lower = [](const std::string& s) -> std::string {
-        return s | ranges::views::transform([](auto c) { return std::tolower(c); }) | ranges::to<std::string>();
+    // case insensitive comparison of element name (without lowering it to new string)
+    auto is_element = [](std::string_view name, std::string_view expected) {
+        return name.size() == expected.size() && std::equal(
+            name.begin(),
+            name.end(),
+            expected.begin(),
+            [](char c, char expected_c) { return std::tolower(static_cast<unsigned char>(c)) == expected_c; });
     };
 
-    auto apply_info = [](DrawState& state, const std::unordered_map<std::string, std::string>& attributes) {
+    auto apply_info = [](DrawState& state, const XmlAttributes& attributes) {
         // display none
         if (state.hide) return;
 
-        if (mff::has(attributes, "display")) {
+        if (attributes.has("display")) {
             if (attributes.at("display") == "none") {
                 state.fill = false;
                 state.stroke = false;
@@ -205,7 +292,7 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
             }
         }
 
-        if (mff::has(attributes, "fill")) {
+        if (attributes.has("fill")) {
             if (attributes.at("fill") == "none") {
                 state.fill = false;
             } else {
@@ -216,7 +303,14 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
             }
         }
 
-        if (mff::has(attributes, "stroke")) {
+        if (attributes.has("fill-rule")) {
+            auto rule = attributes.at("fill-rule");
+
+            if (rule == "nonzero") state.fill_rule = FillRule::NonZero;
+            if (rule == "evenodd") state.fill_rule = FillRule::EvenOdd;
+        }
+
+        if (attributes.has("stroke")) {
             if (attributes.at("stroke") == "none") {
                 state.stroke = false;
             } else {
@@ -227,11 +321,11 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
             }
         }
 
-        if (mff::has(attributes, "stroke-width")) {
-            state.stroke_width = std::stof(attributes.at("stroke-width"));
+        if (attributes.has("stroke-width")) {
+            state.stroke_width = parse_number(attributes.at("stroke-width"));
         }
 
-        if (mff::has(attributes, "stroke-linecap")) {
+        if (attributes.has("stroke-linecap")) {
             auto cap = attributes.at("stroke-linecap");
 
             if (cap == "round") state.line_cap = LineCap_::Round{};
@@ -239,11 +333,11 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
             if (cap == "square") state.line_cap = LineCap_::Square{};
         }
 
-        if (mff::has(attributes, "stroke-miterlimit")) {
-            state.stroke_miterlimit = std::stof(attributes.at("stroke-miterlimit"));
+        if (attributes.has("stroke-miterlimit")) {
+            state.stroke_miterlimit = parse_number(attributes.at("stroke-miterlimit"));
         }
 
-        if (mff::has(attributes, "stroke-linejoin")) {
+        if (attributes.has("stroke-linejoin")) {
             auto cap = attributes.at("stroke-linejoin");
 
             if (cap == "miter") state.line_join = LineJoin_::Miter{state.stroke_miterlimit};
@@ -251,15 +345,15 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
             if (cap == "bevel") state.line_join = LineJoin_::Bevel{};
         }
 
-        if (mff::has(attributes, "fill-opacity")) {
-            state.fill_color[3] = std::stof(attributes.at("fill-opacity"));
+        if (attributes.has("fill-opacity")) {
+            state.fill_color[3] = parse_number(attributes.at("fill-opacity"));
         }
 
-        if (mff::has(attributes, "stroke-opacity")) {
-            state.stroke_color[3] = std::stof(attributes.at("stroke-opacity"));
+        if (attributes.has("stroke-opacity")) {
+            state.stroke_color[3] = parse_number(attributes.at("stroke-opacity"));
         }
 
-        if (mff::has(attributes, "paint-order")) {
+        if (attributes.has("paint-order")) {
             auto po = attributes.at("paint-order");
             if (po == "fill" || po == "normal") {
                 state.paint_first = DrawStatePaintFirst::Fill;
@@ -277,103 +371,103 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
                     states.pop();
                 },
                 [&](const XmlContent_::StartTag& start) {
-                    if (to_lower(start.name) == "g") {
+                    if (is_element(start.name, "g")) {
                         DrawState new_state = states.top();
                         apply_info(new_state, start.attributes);
                         states.push(new_state);
                     }
                 },
                 [&](const XmlContent_::EmptyElementTag& empty) {
-                    if (to_lower(empty.name) == "path" && mff::has(empty.attributes, "d")) {
+                    if (is_element(empty.name, "path") && empty.attributes.has("d")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
                         auto path_string = empty.attributes.at("d");
-                        auto path = Path2D::from_svg_commands(parse_path(path_string).value());
+                        auto path = Path2D::from_svg_commands(parse_path(path_string).value(), get_allocator());
 
-                        result.push_back(std::make_tuple(path, curr_state));
+                        callback(std::move(path), curr_state);
                     }
 
-                    if (to_lower(empty.name) == "rect"
-                        && mff::has(empty.attributes, "width")
-                        && mff::has(empty.attributes, "height")) {
+                    if (is_element(empty.name, "rect")
+                        && empty.attributes.has("width")
+                        && empty.attributes.has("height")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
-                        std::float_t width = std::stof(empty.attributes.at("width"));
-                        std::float_t height = std::stof(empty.attributes.at("height"));
+                        std::float_t width = parse_number(empty.attributes.at("width"));
+                        std::float_t height = parse_number(empty.attributes.at("height"));
 
                         std::float_t x = 0.0f;
-                        if (mff::has(empty.attributes, "x")) {
-                            x = std::stof(empty.attributes.at("x"));
+                        if (empty.attributes.has("x")) {
+                            x = parse_number(empty.attributes.at("x"));
                         }
 
                         std::float_t y = 0.0f;
-                        if (mff::has(empty.attributes, "y")) {
-                            y = std::stof(empty.attributes.at("y"));
+                        if (empty.attributes.has("y")) {
+                            y = parse_number(empty.attributes.at("y"));
                         }
 
-                        Path2D rect = {};
+                        Path2D rect(get_allocator());
                         rect.rect({{x, y}, {width, height}});
 
-                        result.push_back(std::make_tuple(rect, curr_state));
+                        callback(std::move(rect), curr_state);
                     }
 
-                    if (to_lower(empty.name) == "ellipse"
-                        && mff::has(empty.attributes, "rx")
-                        && mff::has(empty.attributes, "ry")) {
+                    if (is_element(empty.name, "ellipse")
+                        && empty.attributes.has("rx")
+                        && empty.attributes.has("ry")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
-                        std::float_t rx = std::stof(empty.attributes.at("rx"));
-                        std::float_t ry = std::stof(empty.attributes.at("ry"));
+                        std::float_t rx = parse_number(empty.attributes.at("rx"));
+                        std::float_t ry = parse_number(empty.attributes.at("ry"));
 
                         std::float_t cx = 0.0f;
-                        if (mff::has(empty.attributes, "cx")) {
-                            cx = std::stof(empty.attributes.at("cx"));
+                        if (empty.attributes.has("cx")) {
+                            cx = parse_number(empty.attributes.at("cx"));
                         }
 
                         std::float_t cy = 0.0f;
-                        if (mff::has(empty.attributes, "cy")) {
-                            cy = std::stof(empty.attributes.at("cy"));
+                        if (empty.attributes.has("cy")) {
+                            cy = parse_number(empty.attributes.at("cy"));
                         }
 
-                        Path2D path = {};
+                        Path2D path(get_allocator());
                         path.ellipse({cx, cy}, {rx, ry});
 
-                        result.push_back(std::make_tuple(path, curr_state));
+                        callback(std::move(path), curr_state);
                     }
 
-                    if (to_lower(empty.name) == "circle"
-                        && mff::has(empty.attributes, "r")) {
+                    if (is_element(empty.name, "circle")
+                        && empty.attributes.has("r")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
-                        std::float_t r = std::stof(empty.attributes.at("r"));
+                        std::float_t r = parse_number(empty.attributes.at("r"));
 
                         std::float_t cx = 0.0f;
-                        if (mff::has(empty.attributes, "cx")) {
-                            cx = std::stof(empty.attributes.at("cx"));
+                        if (empty.attributes.has("cx")) {
+                            cx = parse_number(empty.attributes.at("cx"));
                         }
 
                         std::float_t cy = 0.0f;
-                        if (mff::has(empty.attributes, "cy")) {
-                            cy = std::stof(empty.attributes.at("cy"));
+                        if (empty.attributes.has("cy")) {
+                            cy = parse_number(empty.attributes.at("cy"));
                         }
 
-                        Path2D path = {};
+                        Path2D path(get_allocator());
                         path.ellipse({cx, cy}, {r, r});
 
-                        result.push_back(std::make_tuple(path, curr_state));
+                        callback(std::move(path), curr_state);
                     }
 
-                    if (to_lower(empty.name) == "polygon" && mff::has(empty.attributes, "points")) {
+                    if (is_element(empty.name, "polygon") && empty.attributes.has("points")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
                         auto points_string = empty.attributes.at("points");
                         auto coordinates = parse_coordinates(points_string).value();
-                        Path2D path = {};
+                        Path2D path(get_allocator());
 
                         bool first = true;
                         for (const auto& coord: coordinates) {
@@ -385,16 +479,16 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
 
                         path.close_path();
 
-                        result.push_back(std::make_tuple(path, curr_state));
+                        callback(std::move(path), curr_state);
                     }
 
-                    if (to_lower(empty.name) == "polyline" && mff::has(empty.attributes, "points")) {
+                    if (is_element(empty.name, "polyline") && empty.attributes.has("points")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
                         auto points_string = empty.attributes.at("points");
                         auto coordinates = parse_coordinates(points_string).value();
-                        Path2D path = {};
+                        Path2D path(get_allocator());
 
                         bool first = true;
                         for (const auto& coord: coordinates) {
@@ -404,28 +498,28 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
                             first = false;
                         }
 
-                        result.push_back(std::make_tuple(path, curr_state));
+                        callback(std::move(path), curr_state);
                     }
 
 
-                    if (to_lower(empty.name) == "line"
-                        && mff::has(empty.attributes, "x1")
-                        && mff::has(empty.attributes, "y1")
-                        && mff::has(empty.attributes, "x2")
-                        && mff::has(empty.attributes, "y2")) {
+                    if (is_element(empty.name, "line")
+                        && empty.attributes.has("x1")
+                        && empty.attributes.has("y1")
+                        && empty.attributes.has("x2")
+                        && empty.attributes.has("y2")) {
                         DrawState curr_state = states.top();
                         apply_info(curr_state, empty.attributes);
 
-                        std::float_t x1 = std::stof(empty.attributes.at("x1"));
-                        std::float_t x2 = std::stof(empty.attributes.at("x2"));
-                        std::float_t y1 = std::stof(empty.attributes.at("y1"));
-                        std::float_t y2 = std::stof(empty.attributes.at("y2"));
+                        std::float_t x1 = parse_number(empty.attributes.at("x1"));
+                        std::float_t x2 = parse_number(empty.attributes.at("x2"));
+                        std::float_t y1 = parse_number(empty.attributes.at("y1"));
+                        std::float_t y2 = parse_number(empty.attributes.at("y2"));
 
-                        Path2D path = {};
+                        Path2D path(get_allocator());
                         path.move_to({x1, y1});
                         path.line_to({x2, y2});
 
-                        result.push_back(std::make_tuple(path, curr_state));
+                        callback(std::move(path), curr_state);
                     }
                 },
             },
@@ -433,8 +527,16 @@ std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data) {
         );
 
         next_input = parsed_result->next_input;
-        parsed_result = parse_xml_internal<std::string_view>(next_input);
+        parsed_result = parse_xml_internal(next_input);
     }
+}
+
+std::vector<std::tuple<Path2D, DrawState>> to_paths(std::string_view data) {
+    std::vector<std::tuple<Path2D, DrawState>> result;
+
+    for_each_path(data, [&](Path2D path, const DrawState& state) {
+        result.emplace_back(std::move(path), state);
+    });
 
     return result;
 }
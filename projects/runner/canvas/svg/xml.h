@@ -1,9 +1,14 @@
 #pragma once
 
-#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 #include <mff/leaf.h>
 #include <mff/graphics/math.h>
 #include <mff/parser_combinator/parsers.h>
@@ -13,19 +18,64 @@
 
 namespace canvas::svg {
 
+/**
+ * Attributes of XML element - the names and values point into the parsed document (so they are
+ * valid only while the document is alive). Elements have only a few attributes, so they are stored
+ * inline and looked up linearly (no allocations and no hashing).
+ */
+class XmlAttributes {
+public:
+    using Attribute = std::pair<std::string_view, std::string_view>;
+    using Container = boost::container::small_vector<Attribute, 8>;
+
+    /**
+     * Add the attribute (the later value of the same attribute replaces the previous one)
+     * @param name
+     * @param value
+     */
+    void add(std::string_view name, std::string_view value);
+
+    /**
+     * @param name
+     * @return is there attribute with the name?
+     */
+    bool has(std::string_view name) const;
+
+    /**
+     * Get value of the attribute
+     * @param name
+     * @return
+     */
+    std::optional<std::string_view> get(std::string_view name) const;
+
+    /**
+     * Get value of the attribute which has to exist (throws std::out_of_range otherwise)
+     * @param name
+     * @return
+     */
+    std::string_view at(std::string_view name) const;
+
+    Container::const_iterator begin() const;
+    Container::const_iterator end() const;
+    std::size_t size() const;
+
+private:
+    Container attributes_ = {};
+};
+
 namespace XmlContent_ {
 
 struct EmptyElementTag {
-    std::string name;
-    std::unordered_map<std::string, std::string> attributes;
+    std::string_view name;
+    XmlAttributes attributes;
 };
 
 struct StartTag {
-    std::string name;
-    std::unordered_map<std::string, std::string> attributes;
+    std::string_view name;
+    XmlAttributes attributes;
 };
 struct EndTag {
-    std::string name;
+    std::string_view name;
 };
 struct CharData {
 };
@@ -43,6 +93,7 @@ enum class DrawStatePaintFirst { Stroke, Fill };
 
 struct DrawState {
     mff::Vector4f fill_color = {0.0f, 0.0f, 0.0f, 1.0f};
+    FillRule fill_rule = FillRule::NonZero;
     mff::Vector4f stroke_color = {0.0f, 0.0f, 0.0f, 1.0f};
     std::float_t stroke_width = {};
     LineJoin line_join = LineJoin_::Bevel{};
@@ -54,11 +105,34 @@ struct DrawState {
     DrawStatePaintFirst paint_first = DrawStatePaintFirst::Fill;
 };
 
+using PathCallback = std::function<void(Path2D path, const DrawState& state)>;
+using PathAllocatorCallback = std::function<Path2D::allocator_type()>;
+
+/**
+ * Parse SVG string and pass every shape to the callback as soon as its element is parsed (in
+ * paint order) - nothing but the current element is kept, so the shapes can be processed while
+ * the rest of the document is parsed
+ * @param data
+ * @param callback
+ * @param allocator the allocator of the contours of all the shapes
+ */
+void for_each_path(std::string_view data, const PathCallback& callback, const Path2D::allocator_type& allocator = {});
+
+/**
+ * Parse SVG string and pass every shape to the callback as soon as its element is parsed (in
+ * paint order) - every shape can be allocated by different allocator (e.g. one arena per shape)
+ * @param data
+ * @param callback
+ * @param get_allocator called before every shape is parsed, its contours are allocated by the
+ * returned allocator
+ */
+void for_each_path(std::string_view data, const PathCallback& callback, const PathAllocatorCallback& get_allocator);
+
 /**
  * Parse SVG string to paths
  * @param data
  * @return
  */
-std::vector<std::tuple<Path2D, DrawState>> to_paths(const std::string& data);
+std::vector<std::tuple<Path2D, DrawState>> to_paths(std::string_view data);
 
 }
\ No newline at end of file
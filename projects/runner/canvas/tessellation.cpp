@@ -0,0 +1,1001 @@
+#include "./tessellation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <utility>
+
+#include "../third_party/earcut.hpp"
+
+namespace mapbox::util {
+
+// helpers for mathbox
+template <>
+struct nth<0, ::mff::Vector2f> {
+    inline static auto get(const ::mff::Vector2f& t) {
+        return t[0];
+    };
+};
+template <>
+struct nth<1, ::mff::Vector2f> {
+    inline static auto get(const ::mff::Vector2f& t) {
+        return t[1];
+    };
+};
+
+}
+
+namespace canvas {
+
+namespace {
+
+/**
+ * The contour of path (closed polygon)
+ */
+struct Ring {
+    std::span<const mff::Vector2f> points;
+    // the index of the first point (in the points of all the contours)
+    std::uint32_t first;
+    // signed area (positive for counter-clockwise rings in y-up coordinates)
+    std::float_t area;
+    mff::Vector2f min;
+    mff::Vector2f max;
+    // the smallest ring which contains this one
+    std::optional<std::size_t> parent = std::nullopt;
+};
+
+/**
+ * Is the point inside of the ring? (the ring is simple polygon, so the fill rule does not matter)
+ */
+bool ring_contains(const Ring& ring, const mff::Vector2f& point) {
+    if ((point.array() < ring.min.array()).any() || (point.array() > ring.max.array()).any()) return false;
+
+    bool inside = false;
+
+    for (std::size_t i = 0, j = ring.points.size() - 1; i < ring.points.size(); j = i++) {
+        const auto& a = ring.points[i];
+        const auto& b = ring.points[j];
+
+        if ((a[1] > point[1]) != (b[1] > point[1])
+            && point[0] < (b[0] - a[0]) * (point[1] - a[1]) / (b[1] - a[1]) + a[0]) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+struct SweepEdge;
+
+/**
+ * Vertex of the sweep (the coincident points are merged to one vertex)
+ */
+struct SweepVertex {
+    Eigen::Vector2d position;
+    // the first of the edges which end in this vertex (linked by SweepEdge::next_above)
+    SweepEdge* above = nullptr;
+    // the first of the edges which start in this vertex (linked by SweepEdge::next_below)
+    SweepEdge* below = nullptr;
+    // the index in the result (the vertex is added to the result by the first triangle using it)
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+};
+
+class MonotonePolygon;
+
+/**
+ * Edge of the sweep - it goes from the top vertex to the bottom one (in the order of sweep)
+ */
+struct SweepEdge {
+    SweepVertex* top;
+    SweepVertex* bottom;
+    // +1 if the contour goes from the top to the bottom, -1 otherwise
+    int winding;
+    // the next edge ending in the bottom vertex / starting in the top vertex
+    SweepEdge* next_above = nullptr;
+    SweepEdge* next_below = nullptr;
+
+    // the area right of the active edge (up to the next active edge) - its winding number, its
+    // monotone polygon and the polygon left of it which waits for the next vertex of the area (it
+    // ended in merge vertex)
+    int right_winding = 0;
+    MonotonePolygon* polygon = nullptr;
+    MonotonePolygon* merge = nullptr;
+
+    // the node of active edges (treap ordered from left to right, min-heap by priority)
+    bool active = false;
+    std::uint32_t priority = 0;
+    SweepEdge* parent = nullptr;
+    SweepEdge* left = nullptr;
+    SweepEdge* right = nullptr;
+};
+
+/**
+ * The sweep goes from top to bottom (increasing y) and from left to right in the same y
+ */
+bool is_before(const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+    return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
+}
+
+double cross(const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+/**
+ * Is the point left of the edge?
+ */
+bool is_left_of(const Eigen::Vector2d& point, const SweepEdge* edge) {
+    return cross(edge->bottom->position - edge->top->position, point - edge->top->position) > 0.0;
+}
+
+/**
+ * The active edges (the edges crossing the sweep line) from left to right - the treap, so the edges
+ * are found, inserted and erased in O(log n). The order is given by the positions of insertion
+ * (the edges are never compared by each other), so the rounding errors can not break the tree.
+ */
+class ActiveEdges {
+public:
+    /**
+     * @return the leftmost edge (or nullptr)
+     */
+    SweepEdge* first() const {
+        return root_ ? leftmost(root_) : nullptr;
+    }
+
+    SweepEdge* next(SweepEdge* edge) const {
+        if (edge->right) return leftmost(edge->right);
+
+        while (edge->parent && edge->parent->right == edge) edge = edge->parent;
+
+        return edge->parent;
+    }
+
+    SweepEdge* previous(SweepEdge* edge) const {
+        if (edge->left) return rightmost(edge->left);
+
+        while (edge->parent && edge->parent->left == edge) edge = edge->parent;
+
+        return edge->parent;
+    }
+
+    /**
+     * @param point
+     * @return the rightmost edge left of the point (or nullptr)
+     */
+    SweepEdge* find_left_of(const Eigen::Vector2d& point) const {
+        SweepEdge* result = nullptr;
+
+        for (auto node = root_; node;) {
+            if (is_left_of(point, node)) {
+                node = node->left;
+            } else {
+                result = node;
+                node = node->right;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Insert the edge right after the position (or as the leftmost one if position is nullptr)
+     * @param position
+     * @param edge
+     */
+    void insert_after(SweepEdge* position, SweepEdge* edge) {
+        // pseudo random priority (xorshift) keeps the tree balanced
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+
+        edge->priority = seed_;
+        edge->active = true;
+
+        if (!root_) {
+            root_ = edge;
+        } else if (!position) {
+            attach(leftmost(root_), edge, true);
+        } else if (!position->right) {
+            attach(position, edge, false);
+        } else {
+            attach(leftmost(position->right), edge, true);
+        }
+
+        while (edge->parent && edge->priority < edge->parent->priority) rotate_up(edge);
+    }
+
+    void erase(SweepEdge* edge) {
+        while (edge->left && edge->right) {
+            rotate_up(edge->left->priority < edge->right->priority ? edge->left : edge->right);
+        }
+
+        auto child = edge->left ? edge->left : edge->right;
+
+        if (child) child->parent = edge->parent;
+
+        if (!edge->parent) {
+            root_ = child;
+        } else if (edge->parent->left == edge) {
+            edge->parent->left = child;
+        } else {
+            edge->parent->right = child;
+        }
+
+        edge->active = false;
+        edge->parent = edge->left = edge->right = nullptr;
+    }
+
+private:
+    static SweepEdge* leftmost(SweepEdge* node) {
+        while (node->left) node = node->left;
+
+        return node;
+    }
+
+    static SweepEdge* rightmost(SweepEdge* node) {
+        while (node->right) node = node->right;
+
+        return node;
+    }
+
+    static void attach(SweepEdge* parent, SweepEdge* edge, bool left) {
+        (left ? parent->left : parent->right) = edge;
+        edge->parent = parent;
+    }
+
+    /**
+     * Rotate the node above its parent (the order of nodes does not change)
+     */
+    void rotate_up(SweepEdge* node) {
+        auto parent = node->parent;
+        auto grandparent = parent->parent;
+
+        if (parent->left == node) {
+            parent->left = node->right;
+            if (node->right) node->right->parent = parent;
+            node->right = parent;
+        } else {
+            parent->right = node->left;
+            if (node->left) node->left->parent = parent;
+            node->left = parent;
+        }
+
+        parent->parent = node;
+        node->parent = grandparent;
+
+        if (!grandparent) {
+            root_ = node;
+        } else if (grandparent->left == parent) {
+            grandparent->left = node;
+        } else {
+            grandparent->right = node;
+        }
+    }
+
+    SweepEdge* root_ = nullptr;
+    std::uint32_t seed_ = 2463534242;
+};
+
+/**
+ * The chain of monotone polygon
+ */
+enum class Side {
+    Left,
+    Right
+};
+
+/**
+ * Monotone polygon (in the direction of sweep) - the vertices are added in the order of sweep, so
+ * the polygon is triangulated right away (the vertices which can not be connected yet wait on the
+ * stack, they form reflex chain)
+ */
+class MonotonePolygon {
+public:
+    explicit MonotonePolygon(SweepVertex* top) : stack_{{top, Side::Left}} {}
+
+    /**
+     * @return the last added vertex (the lowest one) and its chain
+     */
+    const std::pair<SweepVertex*, Side>& last() const {
+        return stack_.back();
+    }
+
+    /**
+     * Add the next vertex of chain
+     * @param vertex
+     * @param side
+     * @param result the triangles are added here
+     */
+    void add(SweepVertex* vertex, Side side, FillTessellation& result) {
+        if (stack_.size() > 1 && stack_.back().second != side) {
+            // the vertex sees all the vertices of the other chain
+            for (std::size_t i = 0; i + 1 < stack_.size(); i++) {
+                add_triangle(stack_[i].first, stack_[i + 1].first, vertex, result);
+            }
+
+            stack_.erase(std::begin(stack_), std::end(stack_) - 1);
+        } else {
+            // cut off the convex vertices of the same chain
+            while (stack_.size() > 1) {
+                const auto& a = stack_[stack_.size() - 2].first->position;
+                const auto& b = stack_.back().first->position;
+                auto turn = cross(b - a, vertex->position - a);
+
+                if (side == Side::Left ? turn >= 0.0 : turn <= 0.0) break;
+
+                add_triangle(stack_[stack_.size() - 2].first, stack_.back().first, vertex, result);
+                stack_.pop_back();
+            }
+        }
+
+        stack_.emplace_back(vertex, side);
+    }
+
+    /**
+     * Add the bottom vertex (both chains end in it)
+     * @param vertex
+     * @param result
+     */
+    void close(SweepVertex* vertex, FillTessellation& result) {
+        for (std::size_t i = 0; i + 1 < stack_.size(); i++) {
+            add_triangle(stack_[i].first, stack_[i + 1].first, vertex, result);
+        }
+
+        stack_ = {};
+    }
+
+private:
+    static void add_triangle(SweepVertex* a, SweepVertex* b, SweepVertex* c, FillTessellation& result) {
+        // the vertices are emitted in float, so the triangle can collapse only after the rounding
+        // (the rounded positions are exact in double, so the test is done in double)
+        auto rounded = [](SweepVertex* vertex) -> Eigen::Vector2d {
+            return vertex->position.cast<std::float_t>().cast<double>();
+        };
+        auto ra = rounded(a);
+        if (cross(rounded(b) - ra, rounded(c) - ra) == 0.0) return;
+
+        for (auto vertex: {a, b, c}) {
+            if (vertex->index == std::numeric_limits<std::uint32_t>::max()) {
+                vertex->index = static_cast<std::uint32_t>(result.vertices.size());
+                result.vertices.emplace_back(vertex->position.cast<std::float_t>());
+            }
+
+            result.indices.push_back(vertex->index);
+        }
+    }
+
+    std::vector<std::pair<SweepVertex*, Side>> stack_;
+};
+
+/**
+ * Tessellation of fill by sweep line
+ */
+class SweepTessellator {
+public:
+    SweepTessellator(
+        std::span<const mff::Vector2f> points,
+        std::span<const std::size_t> contour_sizes,
+        FillRule fill_rule
+    ) : fill_rule_(fill_rule) {
+        Eigen::Vector2d min = Eigen::Vector2d::Constant(std::numeric_limits<double>::max());
+        Eigen::Vector2d max = Eigen::Vector2d::Constant(std::numeric_limits<double>::lowest());
+
+        std::size_t first = 0;
+
+        for (auto size: contour_sizes) {
+            auto contour_first = vertices_.size();
+
+            for (const auto& point: points.subspan(first, size)) {
+                vertices_.push_back(SweepVertex{point.cast<double>()});
+                min = min.cwiseMin(vertices_.back().position);
+                max = max.cwiseMax(vertices_.back().position);
+            }
+
+            first += size;
+
+            // the fill always closes the contour
+            for (std::size_t i = 0; i < size; i++) {
+                add_edge(&vertices_[contour_first + i], &vertices_[contour_first + (i + 1) % size]);
+            }
+        }
+
+        if (!vertices_.empty()) epsilon_ = (max - min).maxCoeff() * 1e-10;
+
+        events_.reserve(vertices_.size());
+
+        for (auto& vertex: vertices_) events_.push_back(&vertex);
+
+        std::sort(std::begin(events_), std::end(events_), [](const SweepVertex* a, const SweepVertex* b) {
+            return is_before(a->position, b->position);
+        });
+    }
+
+    /**
+     * Run the sweep over all the vertices
+     * @return the triangles of filled areas
+     */
+    FillTessellation run() {
+        std::size_t next_event = 0;
+
+        // the events are the points of contours (sorted) and the intersections found by sweep
+        auto pop_event = [&]() -> SweepVertex* {
+            if (!intersections_.empty()
+                && (next_event == events_.size()
+                    || is_before(intersections_.top()->position, events_[next_event]->position))) {
+                auto vertex = intersections_.top();
+                intersections_.pop();
+                return vertex;
+            }
+
+            return next_event < events_.size() ? events_[next_event++] : nullptr;
+        };
+
+        auto peek_event = [&]() -> SweepVertex* {
+            if (!intersections_.empty()
+                && (next_event == events_.size()
+                    || is_before(intersections_.top()->position, events_[next_event]->position))) {
+                return intersections_.top();
+            }
+
+            return next_event < events_.size() ? events_[next_event] : nullptr;
+        };
+
+        while (auto vertex = pop_event()) {
+            while (auto coincident = peek_event()) {
+                if (coincident->position != vertex->position) break;
+
+                merge(vertex, pop_event());
+            }
+
+            process(vertex);
+        }
+
+        return std::move(result_);
+    }
+
+private:
+    void add_edge(SweepVertex* a, SweepVertex* b) {
+        if (a->position == b->position) return;
+
+        auto down = is_before(a->position, b->position);
+        auto& edge = edges_.emplace_back(SweepEdge{down ? a : b, down ? b : a, down ? 1 : -1});
+
+        link(&edge);
+    }
+
+    static void link(SweepEdge* edge) {
+        edge->next_above = std::exchange(edge->bottom->above, edge);
+        edge->next_below = std::exchange(edge->top->below, edge);
+    }
+
+    static void unlink_above(SweepEdge* edge) {
+        for (auto current = &edge->bottom->above; *current; current = &(*current)->next_above) {
+            if (*current == edge) {
+                *current = edge->next_above;
+                return;
+            }
+        }
+    }
+
+    /**
+     * Move all the edges of the coincident vertex to the vertex
+     */
+    void merge(SweepVertex* vertex, SweepVertex* coincident) {
+        while (auto edge = coincident->above) {
+            coincident->above = edge->next_above;
+            edge->bottom = vertex;
+            edge->next_above = std::exchange(vertex->above, edge);
+        }
+
+        while (auto edge = coincident->below) {
+            coincident->below = edge->next_below;
+            edge->top = vertex;
+            edge->next_below = std::exchange(vertex->below, edge);
+        }
+    }
+
+    /**
+     * Split the edge in the vertex (the edge ends in the vertex and new edge continues to the
+     * bottom of the original one)
+     */
+    void split(SweepEdge* edge, SweepVertex* vertex) {
+        auto& lower = edges_.emplace_back(SweepEdge{vertex, edge->bottom, edge->winding});
+
+        unlink_above(edge);
+        link(&lower);
+
+        edge->bottom = vertex;
+        edge->next_above = std::exchange(vertex->above, edge);
+    }
+
+    /**
+     * Does the active edge pass through the vertex (up to rounding errors)?
+     */
+    bool passes_through(const SweepEdge* edge, const SweepVertex* vertex) const {
+        Eigen::Vector2d direction = edge->bottom->position - edge->top->position;
+
+        return std::abs(cross(direction, vertex->position - edge->top->position))
+            <= epsilon_ * direction.norm();
+    }
+
+    bool is_filled(int winding) const {
+        return fill_rule_ == FillRule::EvenOdd ? winding % 2 != 0 : winding != 0;
+    }
+
+    MonotonePolygon* add_polygon(SweepVertex* top) {
+        return &polygons_.emplace_back(top);
+    }
+
+    /**
+     * Split the neighbouring active edges where they intersect below the vertex
+     * @param left
+     * @param right
+     * @param vertex the current vertex of sweep
+     */
+    void intersect(SweepEdge* left, SweepEdge* right, SweepVertex* vertex) {
+        if (!left || !right) return;
+
+        // the coincident vertices are merged only when the sweep gets to them
+        if (left->top->position == right->top->position || left->bottom->position == right->bottom->position) return;
+
+        Eigen::Vector2d a = left->bottom->position - left->top->position;
+        Eigen::Vector2d b = right->bottom->position - right->top->position;
+        Eigen::Vector2d offset = right->top->position - left->top->position;
+
+        auto denominator = cross(a, b);
+
+        if (denominator == 0.0) return;
+
+        auto t = cross(offset, b) / denominator;
+        auto s = cross(offset, a) / denominator;
+
+        // the edges touching in the end point are split when the sweep gets to the point
+        if (t <= 0.0 || t >= 1.0 || s <= 0.0 || s >= 1.0) return;
+
+        Eigen::Vector2d position = left->top->position + t * a;
+
+        // the intersection can not be before the sweep line (even if it is rounded)
+        if (!is_before(vertex->position, position)) {
+            position = {
+                std::max(position.x(), std::nextafter(vertex->position.x(), std::numeric_limits<double>::infinity())),
+                vertex->position.y()};
+        }
+
+        // the intersection near the end of edge is the end (if the other edge can be split there)
+        auto is_near = [&](const SweepVertex* end) { return (position - end->position).norm() <= epsilon_; };
+
+        if (is_near(left->bottom) && is_before(left->bottom->position, right->bottom->position)) {
+            split(right, left->bottom);
+        } else if (is_near(right->bottom) && is_before(right->bottom->position, left->bottom->position)) {
+            split(left, right->bottom);
+        } else {
+            // the intersection has to be before the ends of both edges (it can be after them only
+            // by rounding)
+            const auto& end = is_before(left->bottom->position, right->bottom->position)
+                ? left->bottom->position
+                : right->bottom->position;
+
+            if (!is_before(position, end)) {
+                position = {std::nextafter(end.x(), -std::numeric_limits<double>::infinity()), end.y()};
+            }
+
+            if (!is_before(vertex->position, position)) return;
+
+            auto& intersection = vertices_.emplace_back(SweepVertex{position});
+
+            split(left, &intersection);
+            split(right, &intersection);
+            intersections_.push(&intersection);
+        }
+    }
+
+    /**
+     * Move the sweep line over the vertex - the edges ending in the vertex are replaced by the
+     * edges starting in it and the polygons of the areas around the vertex get the vertex
+     * @param vertex
+     */
+    void process(SweepVertex* vertex) {
+        if (!vertex->above && !vertex->below) return;
+
+        // the edges ending in the vertex are next to each other in the active edges
+        SweepEdge* first = nullptr;
+        SweepEdge* last = nullptr;
+
+        if (vertex->above) {
+            first = last = vertex->above;
+
+            for (auto edge = active_.previous(first); edge && edge->bottom == vertex; edge = active_.previous(edge)) {
+                first = edge;
+            }
+
+            for (auto edge = active_.next(last); edge && edge->bottom == vertex; edge = active_.next(edge)) {
+                last = edge;
+            }
+        }
+
+        auto left = first ? active_.previous(first) : active_.find_left_of(vertex->position);
+        auto right = last ? active_.next(last) : (left ? active_.next(left) : active_.first());
+
+        // the edges passing through the vertex end in it as well
+        while (left && (left->bottom == vertex || passes_through(left, vertex))) {
+            if (left->bottom != vertex) split(left, vertex);
+
+            if (!last) last = left;
+            first = left;
+            left = active_.previous(left);
+        }
+
+        while (right && (right->bottom == vertex || passes_through(right, vertex))) {
+            if (right->bottom != vertex) split(right, vertex);
+
+            if (!first) first = right;
+            last = right;
+            right = active_.next(right);
+        }
+
+        // the areas left and right of the vertex (their polygons continue below the vertex)
+        auto winding = left ? left->right_winding : 0;
+        auto left_polygon = left ? left->polygon : nullptr;
+        auto left_merge = left ? left->merge : nullptr;
+        MonotonePolygon* right_polygon = nullptr;
+
+        if (first) {
+            // the vertex is on the right chain of the left area
+            if (left_merge) {
+                left_polygon->close(vertex, result_);
+                left_polygon = left_merge;
+            }
+
+            if (left_polygon) left_polygon->add(vertex, Side::Right, result_);
+
+            // the areas between the edges end in the vertex
+            for (auto edge = first; edge != last; edge = active_.next(edge)) {
+                if (edge->merge) edge->merge->close(vertex, result_);
+                if (edge->polygon) edge->polygon->close(vertex, result_);
+            }
+
+            // the vertex is on the left chain of the right area
+            right_polygon = last->polygon;
+
+            if (last->merge) last->merge->close(vertex, result_);
+            if (right_polygon) right_polygon->add(vertex, Side::Left, result_);
+
+            for (auto edge = first;;) {
+                auto next = active_.next(edge);
+                active_.erase(edge);
+
+                if (edge == last) break;
+
+                edge = next;
+            }
+        } else if (left_merge) {
+            // the vertex below merge vertex connects both polygons
+            left_merge->add(vertex, Side::Right, result_);
+            left_polygon->add(vertex, Side::Left, result_);
+
+            right_polygon = left_polygon;
+            left_polygon = left_merge;
+        } else if (left_polygon) {
+            // the vertex splits the area - the diagonal to the last vertex of the area splits the
+            // polygon
+            auto [helper, side] = left_polygon->last();
+            auto polygon = add_polygon(helper);
+
+            if (side == Side::Left) {
+                polygon->add(vertex, Side::Right, result_);
+                left_polygon->add(vertex, Side::Left, result_);
+
+                right_polygon = left_polygon;
+                left_polygon = polygon;
+            } else {
+                polygon->add(vertex, Side::Left, result_);
+                left_polygon->add(vertex, Side::Right, result_);
+
+                right_polygon = polygon;
+            }
+        }
+
+        // the edges which should have ended here but are elsewhere (only after big rounding errors)
+        for (auto edge = vertex->above; edge; edge = edge->next_above) {
+            if (edge->active) active_.erase(edge);
+        }
+
+        // the edges starting in the vertex from left to right
+        below_.clear();
+
+        for (auto edge = vertex->below; edge; edge = edge->next_below) below_.push_back(edge);
+
+        std::sort(std::begin(below_), std::end(below_), [](const SweepEdge* a, const SweepEdge* b) {
+            return cross(
+                a->bottom->position - a->top->position,
+                b->bottom->position - b->top->position) < 0.0;
+        });
+
+        if (below_.empty()) {
+            // the merge vertex - the left polygon waits for the next vertex of the area
+            if (left) {
+                left->polygon = right_polygon ? right_polygon : left_polygon;
+                left->merge = right_polygon ? left_polygon : nullptr;
+            }
+
+            intersect(left, right, vertex);
+            return;
+        }
+
+        if (left) {
+            left->polygon = left_polygon;
+            left->merge = nullptr;
+        }
+
+        auto position = left;
+
+        for (auto edge: below_) {
+            active_.insert_after(position, edge);
+            position = edge;
+
+            winding += edge->winding;
+            edge->right_winding = winding;
+            edge->polygon = edge != below_.back() && is_filled(winding) ? add_polygon(vertex) : nullptr;
+            edge->merge = nullptr;
+        }
+
+        below_.back()->polygon = right_polygon;
+
+        intersect(left, below_.front(), vertex);
+        intersect(below_.back(), right, vertex);
+    }
+
+    FillRule fill_rule_;
+    // the distance under which the points are considered the same
+    double epsilon_ = 0.0;
+
+    std::deque<SweepVertex> vertices_ = {};
+    std::deque<SweepEdge> edges_ = {};
+    std::deque<MonotonePolygon> polygons_ = {};
+
+    std::vector<SweepVertex*> events_ = {};
+    std::priority_queue<SweepVertex*, std::vector<SweepVertex*>, bool (*)(const SweepVertex*, const SweepVertex*)>
+        intersections_{[](const SweepVertex* a, const SweepVertex* b) { return is_before(b->position, a->position); }};
+
+    ActiveEdges active_ = {};
+    std::vector<SweepEdge*> below_ = {};
+
+    FillTessellation result_ = {};
+};
+
+/**
+ * Edge of the contour for the intersection test
+ */
+struct ContourEdge {
+    mff::Vector2f a;
+    mff::Vector2f b;
+    std::float_t min_x;
+    std::float_t max_x;
+    // the contour of the edge and the position of the edge in it (to recognize adjacent edges)
+    std::size_t contour;
+    std::size_t position;
+    std::size_t contour_size;
+};
+
+/**
+ * Orientation of the point to the line through a and b (positive if it is left of it)
+ */
+double orientation(const mff::Vector2f& a, const mff::Vector2f& b, const mff::Vector2f& point) {
+    return cross(b.cast<double>() - a.cast<double>(), point.cast<double>() - a.cast<double>());
+}
+
+/**
+ * Is the point inside of the bounding box of segment ab? (it is on the segment if it is collinear)
+ */
+bool in_box(const mff::Vector2f& a, const mff::Vector2f& b, const mff::Vector2f& point) {
+    return (point.array() >= a.cwiseMin(b).array()).all() && (point.array() <= a.cwiseMax(b).array()).all();
+}
+
+/**
+ * Do the edges have any common point? (the adjacent edges of contour share their point, so they
+ * touch only if the contour goes back along the edge)
+ */
+bool edges_touch(const ContourEdge& e, const ContourEdge& f) {
+    if (e.contour == f.contour) {
+        if ((e.position + 1) % e.contour_size == f.position) {
+            return orientation(e.a, e.b, f.b) == 0.0 && (e.b - e.a).dot(f.b - f.a) < 0.0f;
+        }
+
+        if ((f.position + 1) % f.contour_size == e.position) {
+            return orientation(f.a, f.b, e.b) == 0.0 && (f.b - f.a).dot(e.b - e.a) < 0.0f;
+        }
+    }
+
+    auto e_fa = orientation(e.a, e.b, f.a);
+    auto e_fb = orientation(e.a, e.b, f.b);
+    auto f_ea = orientation(f.a, f.b, e.a);
+    auto f_eb = orientation(f.a, f.b, e.b);
+
+    if (((e_fa > 0.0 && e_fb < 0.0) || (e_fa < 0.0 && e_fb > 0.0))
+        && ((f_ea > 0.0 && f_eb < 0.0) || (f_ea < 0.0 && f_eb > 0.0))) {
+        return true;
+    }
+
+    return (e_fa == 0.0 && in_box(e.a, e.b, f.a))
+        || (e_fb == 0.0 && in_box(e.a, e.b, f.b))
+        || (f_ea == 0.0 && in_box(f.a, f.b, e.a))
+        || (f_eb == 0.0 && in_box(f.a, f.b, e.b));
+}
+
+}
+
+std::vector<std::uint32_t> triangulate_fill(
+    std::span<const mff::Vector2f> points,
+    std::span<const std::size_t> contour_sizes,
+    FillRule fill_rule
+) {
+    std::vector<Ring> rings;
+    rings.reserve(contour_sizes.size());
+
+    std::size_t first = 0;
+
+    for (auto size: contour_sizes) {
+        Ring ring{
+            points.subspan(first, size),
+            static_cast<std::uint32_t>(first),
+            0.0f,
+            mff::Vector2f::Constant(std::numeric_limits<std::float_t>::max()),
+            mff::Vector2f::Constant(std::numeric_limits<std::float_t>::lowest())
+        };
+        first += size;
+
+        for (std::size_t i = 0, j = size - 1; i < size; j = i++) {
+            const auto& a = ring.points[j];
+            const auto& b = ring.points[i];
+
+            ring.area += a[0] * b[1] - b[0] * a[1];
+            ring.min = ring.min.cwiseMin(b);
+            ring.max = ring.max.cwiseMax(b);
+        }
+
+        ring.area /= 2.0f;
+
+        // the contours without area do not change the fill
+        if (size >= 3 && ring.area != 0.0f) rings.push_back(ring);
+    }
+
+    // the larger rings first (the ring can be contained only in larger ones)
+    std::vector<std::size_t> order(rings.size());
+    std::iota(std::begin(order), std::end(order), 0);
+    std::sort(
+        std::begin(order),
+        std::end(order),
+        [&](std::size_t a, std::size_t b) { return std::abs(rings[a].area) > std::abs(rings[b].area); });
+
+    // the rings do not intersect, so the parent is the smallest larger ring which contains any of
+    // the points of the ring
+    for (std::size_t k = 0; k < order.size(); k++) {
+        auto& ring = rings[order[k]];
+
+        for (std::size_t l = k; l-- > 0;) {
+            if (ring_contains(rings[order[l]], ring.points[0])) {
+                ring.parent = order[l];
+                break;
+            }
+        }
+    }
+
+    // the winding number (or the number of crossed rings for even-odd) of the area inside of ring
+    std::vector<int> winding(rings.size(), 0);
+    auto is_filled = [&](int w) { return fill_rule == FillRule::EvenOdd ? w % 2 != 0 : w != 0; };
+
+    // the outer ring and its holes
+    std::vector<std::vector<std::size_t>> polygons;
+    std::vector<std::optional<std::size_t>> polygon_of(rings.size());
+
+    for (auto index: order) {
+        const auto& ring = rings[index];
+        auto outside = ring.parent ? winding[*ring.parent] : 0;
+
+        winding[index] = outside + (fill_rule == FillRule::EvenOdd || ring.area > 0.0f ? 1 : -1);
+
+        bool filled_inside = is_filled(winding[index]);
+        bool filled_outside = is_filled(outside);
+
+        if (filled_inside && !filled_outside) {
+            polygon_of[index] = polygons.size();
+            polygons.push_back({index});
+        } else if (!filled_inside && filled_outside) {
+            // the hole belongs to the closest outer ring around it (the rings between them do not
+            // change the fill)
+            auto owner = *ring.parent;
+            while (!polygon_of[owner]) owner = *rings[owner].parent;
+
+            polygons[*polygon_of[owner]].push_back(index);
+        }
+    }
+
+    std::vector<std::uint32_t> result;
+    std::vector<std::span<const mff::Vector2f>> polygon;
+    // earcut indexes the points of all the rings of polygon one after another
+    std::vector<std::uint32_t> polygon_points;
+
+    for (const auto& polygon_rings: polygons) {
+        polygon.clear();
+        polygon_points.clear();
+
+        for (auto index: polygon_rings) {
+            const auto& ring = rings[index];
+
+            polygon.push_back(ring.points);
+
+            for (std::uint32_t i = 0; i < ring.points.size(); i++) polygon_points.push_back(ring.first + i);
+        }
+
+        for (auto index: ::mapbox::earcut<std::uint32_t>(polygon)) result.push_back(polygon_points[index]);
+    }
+
+    return result;
+}
+
+bool contours_intersect(std::span<const mff::Vector2f> points, std::span<const std::size_t> contour_sizes) {
+    std::vector<ContourEdge> edges;
+    edges.reserve(points.size());
+
+    std::size_t first = 0;
+    std::vector<mff::Vector2f> contour;
+
+    for (std::size_t c = 0; c < contour_sizes.size(); c++) {
+        auto size = contour_sizes[c];
+
+        // the repeated points do not make any edge
+        contour.clear();
+        for (const auto& point: points.subspan(first, size)) {
+            if (contour.empty() || contour.back() != point) contour.push_back(point);
+        }
+        while (contour.size() > 1 && contour.back() == contour.front()) contour.pop_back();
+
+        first += size;
+
+        // the contours without area are not filled
+        if (contour.size() < 3) continue;
+
+        for (std::size_t i = 0; i < contour.size(); i++) {
+            const auto& a = contour[i];
+            const auto& b = contour[(i + 1) % contour.size()];
+
+            edges.push_back(ContourEdge{a, b, std::min(a[0], b[0]), std::max(a[0], b[0]), c, i, contour.size()});
+        }
+    }
+
+    // only the edges which overlap in x can touch (sweep from left to right)
+    std::sort(
+        std::begin(edges),
+        std::end(edges),
+        [](const ContourEdge& e, const ContourEdge& f) { return e.min_x < f.min_x; });
+
+    std::vector<const ContourEdge*> active;
+
+    for (const auto& edge: edges) {
+        std::erase_if(active, [&](const ContourEdge* other) { return other->max_x < edge.min_x; });
+
+        for (const auto* other: active) {
+            if (std::max(edge.a[1], edge.b[1]) < std::min(other->a[1], other->b[1])) continue;
+            if (std::max(other->a[1], other->b[1]) < std::min(edge.a[1], edge.b[1])) continue;
+
+            if (edges_touch(edge, *other)) return true;
+        }
+
+        active.push_back(&edge);
+    }
+
+    return false;
+}
+
+FillTessellation tessellate_fill(
+    std::span<const mff::Vector2f> points,
+    std::span<const std::size_t> contour_sizes,
+    FillRule fill_rule
+) {
+    return SweepTessellator(points, contour_sizes, fill_rule).run();
+}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <mff/graphics/math.h>
+
+#include "./path.h"
+
+namespace canvas {
+
+/**
+ * Triangulate the fill of path from its flattened contours (every contour is closed polygon, all
+ * of them are stored one after another in points).
+ *
+ * The contours are grouped by the fill rule to polygons with holes (the contour is the outer
+ * boundary of polygon if the area inside of it is filled and the area around it is not, the hole
+ * is the other way around, the contours which do not change the fill are skipped) and every polygon
+ * is triangulated at once. The contours must not intersect each other or themselves (the stencil
+ * fill is exact for any path).
+ * @param points the points of all the contours
+ * @param contour_sizes the number of points of every contour
+ * @param fill_rule
+ * @return the indices (to points) of the triangles
+ */
+std::vector<std::uint32_t> triangulate_fill(
+    std::span<const mff::Vector2f> points,
+    std::span<const std::size_t> contour_sizes,
+    FillRule fill_rule);
+
+/**
+ * Check whether the contours intersect or touch each other or themselves (so they can not be
+ * triangulated by triangulate_fill). Only the edges which overlap in x are compared.
+ * @param points the points of all the contours
+ * @param contour_sizes the number of points of every contour
+ * @return true if any two edges have a common point (besides the point of adjacent edges)
+ */
+bool contours_intersect(std::span<const mff::Vector2f> points, std::span<const std::size_t> contour_sizes);
+
+/**
+ * Triangles of the fill with their own vertices
+ */
+struct FillTessellation {
+    std::vector<mff::Vector2f> vertices = {};
+    std::vector<std::uint32_t> indices = {};
+};
+
+/**
+ * Tessellate the fill of path from its flattened contours by sweep line in O(n log n) (n is the
+ * number of points and intersections).
+ *
+ * The sweep splits the edges where they intersect (so the contours can intersect each other and
+ * themselves), counts the winding number of every area between the edges and decomposes the filled
+ * areas to monotone polygons, which are triangulated while the sweep goes. The vertices are the
+ * points of contours (coincident points are merged) and the intersections.
+ * @param points the points of all the contours
+ * @param contour_sizes the number of points of every contour
+ * @param fill_rule
+ * @return the vertices and indices of the triangles
+ */
+FillTessellation tessellate_fill(
+    std::span<const mff::Vector2f> points,
+    std::span<const std::size_t> contour_sizes,
+    FillRule fill_rule);
+
+}
@@ -2,13 +2,26 @@
 
 #include <cmath>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <variant>
 #include <filesystem>
 
 #include <boost/program_options.hpp>
+#include <mff/arena.h>
 #include <mff/leaf.h>
+#include <mff/mapped_file.h>
+#include <mff/thread_pool.h>
 #include <mff/graphics/logger.h>
 #include <mff/graphics/window.h>
 
@@ -17,7 +30,9 @@
 #include "./canvas/svg/path.h"
 #include "./canvas/svg/xml.h"
 #include "./canvas/canvas.h"
+#include "./canvas/scene_geometry.h"
 #include "./canvas/path.h"
+#include "./canvas/tessellation.h"
 
 struct RunOptions {
     std::string file_name;
@@ -26,61 +41,813 @@ struct RunOptions {
     float scale;
     float translate_x;
     float translate_y;
+    canvas::Canvas::FillMode fill_mode;
+    canvas::Canvas::StrokeMode stroke_mode;
+    // maximal distance (in pixels) of flattened curves from the real ones
+    float tolerance;
+    // render without window and write the image to output_file_name
+    bool headless;
+    std::string output_file_name;
+    // render all the files from directory (or list file) to output_directory
+    std::string batch;
+    std::string output_directory;
+    // only compare the geometry of stroke methods (of the file or all the files of batch)
+    bool stroke_benchmark;
+    // only compare the fill tessellators on synthetic polygons
+    bool tessellation_benchmark;
 };
 
 /**
- * Read an SVG file and prerender it (create all information needed for immediate render)
+ * Size of prerendered geometry
+ */
+struct GeometryCount {
+    std::size_t vertices = 0;
+    std::size_t indices = 0;
+};
+
+/**
+ * Prerender one SVG shape (create all information needed for immediate render)
+ * @param path
+ * @param state
+ * @param base_transform
+ * @param flatten
+ * @param fill_mode
+ * @param stroke_mode
+ * @param stroke_geometry the size of stroke geometry is added to it
+ * @param allocator the allocator of the prerendered geometry
+ * @return the fill and stroke of the shape (in paint order)
+ */
+std::vector<canvas::Canvas::PrerenderedPath> prerender_svg_path(
+    const canvas::Path2D& path,
+    const canvas::svg::DrawState& state,
+    const canvas::Transform2f base_transform,
+    const canvas::FlattenOptions& flatten,
+    canvas::Canvas::FillMode fill_mode,
+    canvas::Canvas::StrokeMode stroke_mode,
+    GeometryCount& stroke_geometry,
+    const canvas::Canvas::PrerenderedPath::allocator_type& allocator = {}
+) {
+    std::vector<canvas::Canvas::PrerenderedPath> prerendered_paths = {};
+
+    auto prerender_fill = [&]() {
+        if (state.fill)
+            prerendered_paths.push_back(
+                canvas::Canvas::prerenderFill(
+                    path,
+                    {state.fill_color, base_transform, state.fill_rule, fill_mode, flatten},
+                    allocator
+                ));
+    };
+
+    auto prerender_stroke = [&]() {
+        if (!state.stroke) return;
+
+        prerendered_paths.push_back(
+            canvas::Canvas::prerenderStroke(
+                path,
+                {state.stroke_color, {state.stroke_width, state.line_cap, state.line_join},
+                    base_transform, flatten, stroke_mode},
+                allocator
+            ));
+
+        stroke_geometry.vertices += prerendered_paths.back().vertices.size();
+        stroke_geometry.indices += prerendered_paths.back().indices.size();
+    };
+
+    if (state.paint_first == canvas::svg::DrawStatePaintFirst::Fill) {
+        prerender_fill();
+        prerender_stroke();
+    } else {
+        prerender_stroke();
+        prerender_fill();
+    }
+
+    return prerendered_paths;
+}
+
+/**
+ * Statistics of streamed SVG file
+ */
+struct StreamedFile {
+    std::size_t shapes_count = 0;
+    // time spent by prerendering (summed over all the threads)
+    std::chrono::duration<double> tessellate_time = {};
+    // allocations of the parsed shapes and their prerendered geometry (summed over all the arenas)
+    mff::ArenaStats shape_arenas = {};
+    // number of arenas (the most of shapes which were parsed or prerendered at once)
+    std::size_t shape_arenas_count = 0;
+    // time spent by freeing all the arenas of the document
+    std::chrono::duration<double> release_time = {};
+    // the size of geometry of all the strokes
+    GeometryCount stroke_geometry = {};
+};
+
+/**
+ * Read an SVG file and prerender its shapes into the scene while it is parsed - every shape is
+ * passed on as soon as its element is parsed, so the tessellation runs while the rest of the file
+ * is parsed. The shapes are added to the scene in paint order.
+ *
+ * Only a bounded number of parsed shapes waits for tessellation (a few per worker), so the memory
+ * does not grow with the document (besides the scene itself).
+ *
+ * Nothing is freed one by one - every shape and its geometry are allocated in one arena, which is
+ * freed at once after the shape is added to the scene and reused by the next shapes (so there are
+ * only as many arenas as shapes in flight).
  * @param file_name
+ * @param scene
  * @param base_transform
+ * @param flatten
+ * @param fill_mode
+ * @param stroke_mode
+ * @param pool if specified the shapes are prerendered on its workers (otherwise immediately)
  * @return
  */
-std::vector<canvas::Canvas::PrerenderedPath> prerender_svg_file(
+StreamedFile stream_svg_file(
     const std::string& file_name,
-    const canvas::Transform2f base_transform
+    canvas::SceneGeometry& scene,
+    const canvas::Transform2f base_transform,
+    const canvas::FlattenOptions& flatten,
+    canvas::Canvas::FillMode fill_mode,
+    canvas::Canvas::StrokeMode stroke_mode,
+    mff::ThreadPool* pool = nullptr
 ) {
-    auto svg_file = mff::read_file(file_name);
-    std::string svg_file_string(svg_file.begin(), svg_file.end());
+    using clock = std::chrono::steady_clock;
+
+    struct Shape {
+        // the path is allocated in this arena (so it has to be declared before it)
+        std::unique_ptr<mff::Arena> arena;
+        canvas::Path2D path;
+        canvas::svg::DrawState state;
+    };
 
-    auto svg_file_paths = canvas::svg::to_paths(svg_file_string);
+    struct Prerendered {
+        // the paths are allocated in this arena (so it has to be declared before them)
+        std::unique_ptr<mff::Arena> arena;
+        std::vector<canvas::Canvas::PrerenderedPath> paths;
+        std::chrono::duration<double> time;
+        GeometryCount stroke_geometry;
+    };
 
-    std::vector<canvas::Canvas::PrerenderedPath> prerendered_paths = {};
+    // the geometry is allocated in the arena of the shape (which is passed on with the geometry)
+    auto prerender = [base_transform, flatten, fill_mode, stroke_mode](Shape shape) -> Prerendered {
+        auto start = clock::now();
+        GeometryCount stroke_geometry;
+        auto paths = prerender_svg_path(
+            shape.path,
+            shape.state,
+            base_transform,
+            flatten,
+            fill_mode,
+            stroke_mode,
+            stroke_geometry,
+            shape.arena.get());
+
+        return {std::move(shape.arena), std::move(paths), clock::now() - start, stroke_geometry};
+    };
 
-    for (const auto& item: svg_file_paths) {
-        auto[path, state] = item;
+    StreamedFile result;
 
-        auto prerender_fill = [&]() {
-            auto[path, state] = item;
+    // arenas which are not used by any shape
+    std::vector<std::unique_ptr<mff::Arena>> free_arenas = {};
+    // arena of the shape which is being parsed (it is passed to its prerender with the shape)
+    std::unique_ptr<mff::Arena> shape_arena = nullptr;
 
-            if (state.fill)
-                prerendered_paths.push_back(canvas::Canvas::prerenderFill(path, {state.fill_color, base_transform}));
-        };
+    auto acquire_arena = [&]() {
+        // most of the shapes are small (the arena grows for the big ones and keeps its largest chunk)
+        if (free_arenas.empty()) return std::make_unique<mff::Arena>(4 * 1024);
 
-        auto prerender_stroke = [&]() {
-            auto[path, state] = item;
+        auto arena = std::move(free_arenas.back());
+        free_arenas.pop_back();
 
-            if (state.stroke)
-                prerendered_paths.push_back(
-                    canvas::Canvas::prerenderStroke(
-                        path,
-                        {state.stroke_color, {state.stroke_width, state.line_cap, state.line_join},
-                            base_transform}
-                    ));
-        };
+        return arena;
+    };
+
+    auto get_shape_allocator = [&]() {
+        if (shape_arena == nullptr) shape_arena = acquire_arena();
+
+        return canvas::Path2D::allocator_type(shape_arena.get());
+    };
 
-        if (state.paint_first == canvas::svg::DrawStatePaintFirst::Fill) {
-            prerender_fill();
-            prerender_stroke();
-        } else {
-            prerender_stroke();
-            prerender_fill();
+    auto add_to_scene = [&](Prerendered prerendered) {
+        for (const auto& path: prerendered.paths) {
+            scene.add(path);
         }
+
+        result.tessellate_time += prerendered.time;
+        result.stroke_geometry.vertices += prerendered.stroke_geometry.vertices;
+        result.stroke_geometry.indices += prerendered.stroke_geometry.indices;
+
+        // the geometry is copied to the scene, so all of it can be freed at once
+        prerendered.paths.clear();
+        prerendered.arena->reset();
+        free_arenas.push_back(std::move(prerendered.arena));
+    };
+
+    std::size_t max_in_flight = pool ? pool->get_threads_count() * 4 : 0;
+    std::deque<std::future<Prerendered>> in_flight = {};
+
+    auto add_oldest_to_scene = [&]() {
+        auto& future = in_flight.front();
+
+        // help the workers instead of blocking (the parsing thread can be one of them)
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!pool->run_pending_task()) std::this_thread::yield();
+        }
+
+        add_to_scene(future.get());
+        in_flight.pop_front();
+    };
+
+    // the file is mapped to memory and parsed in place (it is never copied)
+    mff::MappedFile svg_file(file_name);
+
+    // the tasks own the shapes and their arenas, so they do not have to be waited for on error
+    canvas::svg::for_each_path(
+        svg_file.view(),
+        [&](canvas::Path2D path, const canvas::svg::DrawState& state) {
+            result.shapes_count++;
+
+            Shape shape{std::move(shape_arena), std::move(path), state};
+
+            if (!pool) {
+                add_to_scene(prerender(std::move(shape)));
+                return;
+            }
+
+            in_flight.push_back(pool->submit(
+                [prerender, shape = std::move(shape)]() mutable {
+                    return prerender(std::move(shape));
+                }
+            ));
+
+            while (in_flight.size() > max_in_flight) add_oldest_to_scene();
+        },
+        get_shape_allocator
+    );
+
+    while (!in_flight.empty()) add_oldest_to_scene();
+
+    result.shape_arenas_count = free_arenas.size();
+
+    for (const auto& arena: free_arenas) {
+        const auto& stats = arena->get_stats();
+
+        result.shape_arenas.allocations += stats.allocations;
+        result.shape_arenas.bytes_allocated += stats.bytes_allocated;
+        result.shape_arenas.chunks += stats.chunks;
+        result.shape_arenas.bytes_reserved += stats.bytes_reserved;
+        result.shape_arenas.resets += stats.resets;
     }
 
-    return prerendered_paths;
+    // all the shapes are destroyed, so the arenas are freed at once
+    auto release_start = clock::now();
+    free_arenas.clear();
+    result.release_time = clock::now() - release_start;
+
+    return result;
 }
 
 /**
- *
+ * Get the transform from SVG coordinates to screen coordinates (pixels)
+ * @param ro
+ * @return
+ */
+canvas::Transform2f get_screen_transform(const RunOptions& ro) {
+    // move everything as specified in command arguments
+    return canvas::Transform2f::from_translate({ro.translate_x, ro.translate_y})
+        // scale everything
+        * canvas::Transform2f::from_scale({ro.scale, ro.scale});
+}
+
+/**
+ * Get the transform from SVG coordinates to Vulkan coordinates
+ * @param ro
+ * @param dimensions dimensions of the rendered image
+ * @return
+ */
+canvas::Transform2f get_base_transform(const RunOptions& ro, mff::Vector2ui dimensions) {
+    // Vulkan coordinates are (0,0) in center of screen se at first we will move everything to
+    // the upper left corner
+    return (canvas::Transform2f::from_translate({-1, -1})
+        // then scale everything by framebuffer size (could be by window size...)
+        * canvas::Transform2f::from_scale(dimensions.cast<std::float_t>()).inverse())
+        * get_screen_transform(ro);
+}
+
+/**
+ * Get the options of curve flattening (the tolerance is in pixels)
+ * @param ro
+ * @return
+ */
+canvas::FlattenOptions get_flatten_options(const RunOptions& ro) {
+    canvas::FlattenOptions options;
+    options.tolerance = ro.tolerance;
+    options.transform = get_screen_transform(ro);
+
+    return options;
+}
+
+/**
+ * Load the SVG file, upload all of its geometry as one scene and render it (in one frame)
+ * @param render_init
+ * @param ro
+ * @param scene the scene to which the geometry is uploaded (has to live while it is drawn)
+ * @return
+ */
+boost::leaf::result<void> render_svg_file(
+    RendererInit* render_init,
+    const RunOptions& ro,
+    canvas::SceneGeometry& scene
+) {
+    auto base_transform = get_base_transform(ro, render_init->get_dimensions());
+
+    // Init the canvas on which we will render
+    canvas::Canvas canvas(render_init->get_renderer());
+
+    // the shapes are independent, so they are prerendered on all cores while the file is parsed
+    // (the SVG is static so we pack all of its geometry to one scene and upload it to GPU only once)
+    auto stream_start = std::chrono::steady_clock::now();
+    mff::ThreadPool pool;
+
+    auto streamed = stream_svg_file(
+        ro.file_name,
+        scene,
+        base_transform,
+        get_flatten_options(ro),
+        ro.fill_mode,
+        ro.stroke_mode,
+        &pool);
+
+    logger::main->info(
+        "Parsed and prerendered {} shapes in {:.3f} ms ({:.3f} ms of tessellation on {} threads)",
+        streamed.shapes_count,
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - stream_start).count() * 1000.0,
+        streamed.tessellate_time.count() * 1000.0,
+        pool.get_threads_count());
+    logger::main->info(
+        "{} arenas served {} allocations ({} chunks, {:.1f} KiB kept), released in {:.3f} ms",
+        streamed.shape_arenas_count,
+        streamed.shape_arenas.allocations,
+        streamed.shape_arenas.chunks,
+        streamed.shape_arenas.bytes_reserved / 1024.0,
+        streamed.release_time.count() * 1000.0);
+    logger::main->info(
+        "Strokes have {} vertices and {} indices",
+        streamed.stroke_geometry.vertices,
+        streamed.stroke_geometry.indices);
+
+    auto renderer = render_init->get_renderer();
+    LEAF_CHECK(scene.upload(renderer));
+
+    logger::main->info(
+        "Scene has {} records ({} vertices, {} indices)",
+        scene.get_records().size(),
+        scene.get_vertices().size(),
+        scene.get_indices().size());
+
+    // now we will render everything in canvas (in one frame)
+    LEAF_CHECK(renderer->begin_frame());
+    LEAF_CHECK(canvas.drawScene(scene));
+    LEAF_CHECK(renderer->end_frame());
+
+    return {};
+}
+
+/**
+ * Render the SVG file without any window and write the image to the output file
+ * @param ro
+ * @return
+ */
+boost::leaf::result<void> run_headless(const RunOptions& ro) {
+    LEAF_AUTO(
+        render_init,
+        RendererInit::build_headless({static_cast<std::uint32_t>(ro.width), static_cast<std::uint32_t>(ro.height)}));
+
+    canvas::SceneGeometry scene;
+    LEAF_CHECK(render_svg_file(render_init.get(), ro, scene));
+
+    LEAF_AUTO(pixels, render_init->read_pixels());
+    LEAF_CHECK(write_image(ro.output_file_name, pixels));
+
+    logger::main->info("Image written to \"{}\"", ro.output_file_name);
+
+    return {};
+}
+
+/**
+ * Get the list of files rendered in batch mode
+ * @param batch directory (all the .svg files in it are used) or file with one path per line
+ * @return
+ */
+std::vector<std::string> collect_batch_files(const std::string& batch) {
+    std::vector<std::string> result = {};
+
+    if (std::filesystem::is_directory(batch)) {
+        for (const auto& entry: std::filesystem::directory_iterator(batch)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".svg") {
+                result.push_back(entry.path().string());
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+    } else {
+        std::ifstream list(batch);
+        std::string line;
+
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) result.push_back(line);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Get the image file for the file rendered in batch mode. The name is built from the path of the
+ * file relative to the batch directory (or to the working directory for list file), so the files
+ * of the same name in different directories do not overwrite each other.
+ * @param ro
+ * @param file_name
+ * @return
+ */
+std::filesystem::path get_batch_output_path(const RunOptions& ro, const std::string& file_name) {
+    auto base = std::filesystem::is_directory(ro.batch)
+        ? std::filesystem::path(ro.batch)
+        : std::filesystem::current_path();
+    auto file = std::filesystem::weakly_canonical(file_name);
+    auto relative = file.lexically_relative(std::filesystem::weakly_canonical(base));
+
+    // the file outside of base keeps its whole path (without the root)
+    if (relative.empty() || *relative.begin() == "..") relative = file.relative_path();
+
+    return (std::filesystem::path(ro.output_directory) / relative).replace_extension(".ppm");
+}
+
+/**
+ * File parsed and tessellated on worker thread (ready to be uploaded)
+ */
+struct PreparedFile {
+    std::string file_name;
+    canvas::SceneGeometry scene;
+    std::chrono::duration<double> parse_time;
+    std::chrono::duration<double> tessellate_time;
+};
+
+/**
+ * Total time spent in the phases of batch rendering
+ */
+struct BatchTimings {
+    std::chrono::duration<double> parse = {};
+    std::chrono::duration<double> tessellate = {};
+    std::chrono::duration<double> render = {};
+    std::chrono::duration<double> readback = {};
+    std::chrono::duration<double> write = {};
+};
+
+/**
+ * Parse and tessellate the SVG file (can be called from any thread)
+ * @param file_name
+ * @param base_transform
+ * @param flatten
+ * @param fill_mode
+ * @param stroke_mode
+ * @return
+ */
+PreparedFile prepare_svg_file(
+    const std::string& file_name,
+    const canvas::Transform2f base_transform,
+    const canvas::FlattenOptions flatten,
+    canvas::Canvas::FillMode fill_mode,
+    canvas::Canvas::StrokeMode stroke_mode
+) {
+    using clock = std::chrono::steady_clock;
+
+    PreparedFile result;
+    result.file_name = file_name;
+
+    // every file is prepared on single worker (the parse and tessellation are interleaved)
+    auto start = clock::now();
+    auto streamed = stream_svg_file(file_name, result.scene, base_transform, flatten, fill_mode, stroke_mode);
+
+    result.tessellate_time = streamed.tessellate_time;
+    result.parse_time = (clock::now() - start) - result.tessellate_time;
+
+    return result;
+}
+
+/**
+ * Render all the files of batch with one renderer (the Vulkan instance, device and pipelines are
+ * created only once). The files are parsed and tessellated on worker threads while the previous
+ * files are rendered and read back.
+ * @param ro
+ * @return
+ */
+boost::leaf::result<void> run_batch(const RunOptions& ro) {
+    using clock = std::chrono::steady_clock;
+
+    auto files = collect_batch_files(ro.batch);
+
+    if (files.empty()) {
+        logger::main->warn("No files to render in \"{}\"", ro.batch);
+        return {};
+    }
+
+    std::filesystem::create_directories(ro.output_directory);
+
+    auto batch_start = clock::now();
+
+    LEAF_AUTO(
+        render_init,
+        RendererInit::build_headless({static_cast<std::uint32_t>(ro.width), static_cast<std::uint32_t>(ro.height)}));
+
+    auto startup_time = std::chrono::duration<double>(clock::now() - batch_start);
+
+    auto renderer = render_init->get_renderer();
+    auto base_transform = get_base_transform(ro, render_init->get_dimensions());
+    auto flatten = get_flatten_options(ro);
+    canvas::Canvas canvas(renderer);
+
+    // the files are prepared in parallel (every one on single worker) - keep the workers busy, at
+    // most one prepared file per worker is waiting for render
+    mff::ThreadPool pool;
+    std::size_t max_prepared = pool.get_threads_count();
+    std::deque<std::future<PreparedFile>> prepared = {};
+    std::size_t next_file = 0;
+
+    auto prepare_next = [&]() {
+        while (next_file < files.size() && prepared.size() < max_prepared) {
+            prepared.push_back(pool.submit(
+                [
+                    file_name = files[next_file++],
+                    base_transform,
+                    flatten,
+                    fill_mode = ro.fill_mode,
+                    stroke_mode = ro.stroke_mode
+                ]() {
+                    return prepare_svg_file(file_name, base_transform, flatten, fill_mode, stroke_mode);
+                }
+            ));
+        }
+    };
+
+    BatchTimings timings;
+    std::size_t rendered = 0;
+    std::size_t failed = 0;
+
+    prepare_next();
+
+    for (std::size_t i = 0; i < files.size(); i++) {
+        auto future = std::move(prepared.front());
+        prepared.pop_front();
+        prepare_next();
+
+        std::optional<PreparedFile> file;
+
+        try {
+            file = future.get();
+        } catch (std::exception& e) {
+            logger::main->error("Could not render \"{}\": {}", files[i], e.what());
+            failed++;
+            continue;
+        }
+
+        timings.parse += file->parse_time;
+        timings.tessellate += file->tessellate_time;
+
+        auto render_start = clock::now();
+        auto readback_start = render_start;
+        auto write_start = render_start;
+
+        // the error of one file does not stop the batch
+        bool file_rendered = boost::leaf::try_handle_all(
+            [&]() -> boost::leaf::result<bool> {
+                LEAF_CHECK(file->scene.upload(renderer));
+                LEAF_CHECK(renderer->begin_frame(mff::Vector4f::Zero()));
+                LEAF_CHECK(canvas.drawScene(file->scene));
+                LEAF_CHECK(renderer->end_frame());
+                LEAF_CHECK(renderer->wait());
+
+                readback_start = clock::now();
+
+                LEAF_AUTO(pixels, render_init->read_pixels());
+
+                write_start = clock::now();
+
+                auto output_path = get_batch_output_path(ro, file->file_name);
+                // the failure to create the directory is reported by write_image
+                std::error_code error;
+                std::filesystem::create_directories(output_path.parent_path(), error);
+                LEAF_CHECK(write_image(output_path.string(), pixels));
+
+                return true;
+            },
+            [&](boost::leaf::error_info const& info) {
+                logger::main->error("Could not render \"{}\" (error {})", files[i], info.error().value());
+                return false;
+            }
+        );
+
+        file->scene.release(renderer);
+
+        if (!file_rendered) {
+            failed++;
+            continue;
+        }
+
+        timings.render += readback_start - render_start;
+        timings.readback += write_start - readback_start;
+        timings.write += clock::now() - write_start;
+        rendered++;
+    }
+
+    auto total_time = std::chrono::duration<double>(clock::now() - batch_start);
+
+    auto report = [&](const char* phase, std::chrono::duration<double> time) {
+        logger::main->info(
+            "  {:<10} {:>10.3f} ms total, {:>8.3f} ms per file",
+            phase,
+            time.count() * 1000.0,
+            time.count() * 1000.0 / std::max<std::size_t>(rendered, 1));
+    };
+
+    logger::main->info(
+        "Rendered {} files ({} failed) in {:.3f} s ({:.2f} files/s)",
+        rendered,
+        failed,
+        total_time.count(),
+        rendered / total_time.count());
+    logger::main->info("  {:<10} {:>10.3f} ms", "startup", startup_time.count() * 1000.0);
+    logger::main->info(
+        "  {:<10} {:>10.3f} ms ({} pipeline cache)",
+        "pipelines",
+        renderer->get_context()->get_pipelines_build_time().count() * 1000.0,
+        renderer->get_context()->get_device()->get_pipeline_cache()->is_warm() ? "warm" : "cold");
+    // parse and tessellate run on worker threads (overlapped with render of previous files)
+    report("parse", timings.parse);
+    report("tessellate", timings.tessellate);
+    report("render", timings.render);
+    report("readback", timings.readback);
+    report("write", timings.write);
+
+    return {};
+}
+
+/**
+ * Compare the size of geometry and the time of prerender of all the ways of stroking (on the file
+ * or all the files of batch) - nothing is rendered
+ * @param ro
+ * @return
+ */
+boost::leaf::result<void> run_stroke_benchmark(const RunOptions& ro) {
+    using clock = std::chrono::steady_clock;
+
+    struct StrokeMethod {
+        const char* name;
+        canvas::Canvas::StrokeMode mode;
+        canvas::StrokeTopology topology;
+        GeometryCount geometry = {};
+        std::chrono::duration<double> time = {};
+    };
+
+    std::array<StrokeMethod, 3> methods = {
+        StrokeMethod{"outline", canvas::Canvas::StrokeMode::Outline, canvas::StrokeTopology::TriangleList},
+        StrokeMethod{"list", canvas::Canvas::StrokeMode::Triangulate, canvas::StrokeTopology::TriangleList},
+        StrokeMethod{"strip", canvas::Canvas::StrokeMode::Triangulate, canvas::StrokeTopology::TriangleStrip}
+    };
+
+    auto files = ro.batch.empty() ? std::vector<std::string>{ro.file_name} : collect_batch_files(ro.batch);
+    auto base_transform = get_base_transform(
+        ro,
+        {static_cast<std::uint32_t>(ro.width), static_cast<std::uint32_t>(ro.height)});
+    auto flatten = get_flatten_options(ro);
+    std::size_t strokes_count = 0;
+
+    for (const auto& file_name: files) {
+        try {
+            mff::MappedFile svg_file(file_name);
+
+            canvas::svg::for_each_path(
+                svg_file.view(),
+                [&](canvas::Path2D path, const canvas::svg::DrawState& state) {
+                    if (!state.stroke) return;
+
+                    strokes_count++;
+
+                    for (auto& method: methods) {
+                        auto start = clock::now();
+                        auto prerendered = canvas::Canvas::prerenderStroke(
+                            path,
+                            {state.stroke_color, {state.stroke_width, state.line_cap, state.line_join},
+                                base_transform, flatten, method.mode, method.topology});
+
+                        method.time += clock::now() - start;
+                        method.geometry.vertices += prerendered.vertices.size();
+                        method.geometry.indices += prerendered.indices.size();
+                    }
+                }
+            );
+        } catch (std::exception& e) {
+            logger::main->error("Could not stroke \"{}\": {}", file_name, e.what());
+        }
+    }
+
+    logger::main->info("Stroked {} paths of {} files", strokes_count, files.size());
+
+    for (const auto& method: methods) {
+        auto bytes = method.geometry.vertices * sizeof(Vertex) + method.geometry.indices * sizeof(std::uint32_t);
+
+        logger::main->info(
+            "  {:<8} {:>10} vertices {:>10} indices {:>10.1f} bytes per path {:>10.3f} ms",
+            method.name,
+            method.geometry.vertices,
+            method.geometry.indices,
+            static_cast<double>(bytes) / std::max<std::size_t>(strokes_count, 1),
+            method.time.count() * 1000.0);
+    }
+
+    return {};
+}
+
+/**
+ * Compare the time of fill tessellation by earcut and by sweep line on synthetic polygons with 10k
+ * to 1M points - nothing is rendered
+ * @return
+ */
+boost::leaf::result<void> run_tessellation_benchmark() {
+    using clock = std::chrono::steady_clock;
+
+    // earcut takes minutes on the largest polygons
+    constexpr std::size_t kEARCUT_MAX_POINTS = 100000;
+
+    struct Polygon {
+        const char* name;
+        std::vector<mff::Vector2f> points = {};
+        std::vector<std::size_t> contour_sizes = {};
+    };
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<std::float_t> jitter(0.5f, 1.0f);
+
+    auto add_circle = [](Polygon& polygon, std::size_t count, auto radius) {
+        for (std::size_t i = 0; i < count; i++) {
+            auto angle = static_cast<std::float_t>(2.0 * M_PI * i / count);
+            auto r = radius(angle);
+
+            polygon.points.emplace_back(r * std::cos(angle), r * std::sin(angle));
+        }
+
+        polygon.contour_sizes.push_back(count);
+    };
+
+    for (std::size_t count: {10000, 100000, 1000000}) {
+        std::array<Polygon, 3> polygons = {Polygon{"circle"}, Polygon{"star"}, Polygon{"ring"}};
+
+        // flattened long curve
+        add_circle(polygons[0], count, [](auto) { return 400.0f; });
+        // a lot of reflex vertices (the sweep line crosses a lot of edges)
+        add_circle(polygons[1], count, [&](auto) { return 400.0f * jitter(random); });
+        // wavy contour with a hole (the hole goes the other way)
+        add_circle(polygons[2], count / 2, [](auto angle) { return 400.0f + 10.0f * std::sin(50.0f * angle); });
+        add_circle(polygons[2], count / 2, [](auto angle) { return 200.0f + 10.0f * std::sin(50.0f * angle); });
+        std::reverse(std::begin(polygons[2].points) + count / 2, std::end(polygons[2].points));
+
+        for (const auto& polygon: polygons) {
+            auto start = clock::now();
+            auto tessellation = canvas::tessellate_fill(
+                polygon.points,
+                polygon.contour_sizes,
+                canvas::FillRule::NonZero);
+            std::chrono::duration<double> sweep_time = clock::now() - start;
+
+            auto earcut = fmt::format("{:>12}", "skipped");
+
+            if (count <= kEARCUT_MAX_POINTS) {
+                start = clock::now();
+                auto indices = canvas::triangulate_fill(
+                    polygon.points,
+                    polygon.contour_sizes,
+                    canvas::FillRule::NonZero);
+                std::chrono::duration<double> earcut_time = clock::now() - start;
+
+                earcut = fmt::format("{:>9.3f} ms ({} triangles)", earcut_time.count() * 1000.0, indices.size() / 3);
+            }
+
+            logger::main->info(
+                "  {:>8} points {:<7} sweep {:>9.3f} ms ({} triangles), earcut {}",
+                count,
+                polygon.name,
+                sweep_time.count() * 1000.0,
+                tessellation.indices.size() / 3,
+                earcut);
+        }
+    }
+
+    return {};
+}
+
+/**
+ * Render the SVG file to window
  * @param ro
  * @return
  */
@@ -100,25 +867,8 @@ boost::leaf::result<void> run(const RunOptions& ro) {
     // Init all utils needed for render
     LEAF_AUTO(render_init, RendererInit::build(window));
 
-    // Vulkan coordinates are (0,0) in center of screen se at first we will move everything to
-    // the upper left corner
-    canvas::Transform2f base_transform = (canvas::Transform2f::from_translate({-1, -1})
-        // then scale everything by framebuffer size (could be by window size...)
-        * canvas::Transform2f::from_scale(render_init->get_dimensions().cast<std::float_t>()).inverse())
-        // move everything as specified in command arguments
-        * canvas::Transform2f::from_translate({ro.translate_x, ro.translate_y})
-            // scale everything
-        * canvas::Transform2f::from_scale({ro.scale, ro.scale});
-
-    // Init the canvas on which we will render
-    canvas::Canvas canvas(render_init->get_renderer());
-
-    auto prerendered_paths = prerender_svg_file(ro.file_name, base_transform);
-
-    // now we will render everything in canvas
-    for (const auto& path: prerendered_paths) {
-        canvas.drawPrerendered(path);
-    }
+    canvas::SceneGeometry scene;
+    LEAF_CHECK(render_svg_file(render_init.get(), ro, scene));
 
     auto draw = [&]() -> boost::leaf::result<void> {
         // and now we will just present the canvas to user
@@ -180,7 +930,32 @@ std::optional<RunOptions> parse_command_line_options(int argc, char** argv) {
                 po::value<float>(&result.translate_y)->default_value(0.0f),
                 "set y translation of displayed image"
             )
-            ("file,f", po::value<std::string>(&result.file_name)->required(), "the file to display");
+            (
+                "tolerance",
+                po::value<float>(&result.tolerance)->default_value(0.25f),
+                "set maximal distance (in pixels) of flattened curves from the real ones"
+            )
+            ("stencil_then_cover", "fill the paths through stencil instead of CPU triangulation")
+            ("stroke_outline", "stroke by offsetting the curves and filling the outline instead of the flattened paths")
+            ("headless", "render without window and write the image to output file")
+            ("stroke_benchmark", "compare the geometry of stroke methods of the file (or batch) without rendering")
+            ("tessellation_benchmark", "compare the fill tessellators on synthetic polygons without rendering")
+            (
+                "output,o",
+                po::value<std::string>(&result.output_file_name)->default_value("output.ppm"),
+                "the file to which is the image written in headless mode (.ppm or .pam)"
+            )
+            (
+                "batch",
+                po::value<std::string>(&result.batch),
+                "render all the .svg files from directory (or files listed in file, one per line) headless"
+            )
+            (
+                "output_dir",
+                po::value<std::string>(&result.output_directory)->default_value("."),
+                "the directory to which are the images written in batch mode (the paths of the files relative to the batch directory are kept)"
+            )
+            ("file,f", po::value<std::string>(&result.file_name), "the file to display");
 
         po::positional_options_description p;
         p.add("file", 1);
@@ -194,6 +969,33 @@ std::optional<RunOptions> parse_command_line_options(int argc, char** argv) {
 
         po::notify(vm);
 
+        result.headless = vm.count("headless") > 0;
+        result.stroke_benchmark = vm.count("stroke_benchmark") > 0;
+        result.tessellation_benchmark = vm.count("tessellation_benchmark") > 0;
+        result.fill_mode = vm.count("stencil_then_cover")
+            ? canvas::Canvas::FillMode::StencilThenCover
+            : canvas::Canvas::FillMode::Triangulate;
+        result.stroke_mode = vm.count("stroke_outline")
+            ? canvas::Canvas::StrokeMode::Outline
+            : canvas::Canvas::StrokeMode::Triangulate;
+
+        // the synthetic polygons do not need any file
+        if (result.tessellation_benchmark) return result;
+
+        if (!result.batch.empty()) {
+            if (!std::filesystem::exists(result.batch)) {
+                std::cout << fmt::format("Specified batch \"{}\" does not exists", result.batch) << std::endl;
+                return std::nullopt;
+            }
+
+            return result;
+        }
+
+        if (result.file_name.empty()) {
+            std::cout << "No file specified" << std::endl;
+            return std::nullopt;
+        }
+
         if (!std::filesystem::exists(result.file_name)) {
             std::cout << fmt::format("Specified file \"{}\" does not exists", result.file_name) << std::endl;
             return std::nullopt;
@@ -222,7 +1024,17 @@ int main(int argc, char* argv[]) {
     // run everything in boost leaf context
     return boost::leaf::try_handle_all(
         [&]() -> boost::leaf::result<int> {
-            LEAF_CHECK(run(options.value()));
+            if (options->tessellation_benchmark) {
+                LEAF_CHECK(run_tessellation_benchmark());
+            } else if (options->stroke_benchmark) {
+                LEAF_CHECK(run_stroke_benchmark(options.value()));
+            } else if (!options->batch.empty()) {
+                LEAF_CHECK(run_batch(options.value()));
+            } else if (options->headless) {
+                LEAF_CHECK(run_headless(options.value()));
+            } else {
+                LEAF_CHECK(run(options.value()));
+            }
 
             return 0;
         },
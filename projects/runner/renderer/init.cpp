@@ -31,6 +31,25 @@ boost::leaf::result<std::unique_ptr<RendererInit>> RendererInit::build(
     return result;
 }
 
+boost::leaf::result<std::unique_ptr<RendererInit>> RendererInit::build_headless(mff::Vector2ui dimensions) {
+    logger::main->debug("Building headless RenderInit");
+    struct enable_RenderInit : public RendererInit {};
+    std::unique_ptr<RendererInit> result = std::make_unique<enable_RenderInit>();
+
+    LEAF_AUTO_TO(result->engine_, VulkanEngine::build_headless());
+
+    // there is no swapchain to dictate the format, so use the one which is supported everywhere
+    LEAF_AUTO_TO(
+        result->context_,
+        RendererContext::build(result->engine_.get(), vk::Format::eR8G8B8A8Unorm));
+    LEAF_AUTO_TO(result->surface_, RendererSurface::build(result->context_.get(), dimensions));
+    LEAF_AUTO_TO(
+        result->renderer_,
+        Renderer::build(result->surface_.get(), result->engine_->get_queues().graphics_queue));
+
+    return result;
+}
+
 Renderer* RendererInit::get_renderer() {
     return renderer_.get();
 }
@@ -40,6 +59,11 @@ mff::Vector2ui RendererInit::get_dimensions() {
 }
 
 boost::leaf::result<void> RendererInit::present() {
+    // presenter reads the surface image - so the submitted frame has to be rendered
+    LEAF_CHECK(renderer_->wait());
+
+    if (presenter_ == nullptr) return {};
+
     LEAF_AUTO(fresh, presenter_->draw());
 
     // if is swapchain invalidated rebuild the commands (so they refer to the new swapchain)
@@ -51,4 +75,8 @@ boost::leaf::result<void> RendererInit::present() {
     engine_->get_device()->get_handle().waitIdle();
 
     return {};
-}
\ No newline at end of file
+}
+
+boost::leaf::result<PixelData> RendererInit::read_pixels() {
+    return renderer_->read_pixels();
+}
@@ -12,7 +12,7 @@
 
 /**
  * Init everything for rendering
- * - Vulkan Engine and Presenter
+ * - Vulkan Engine and Presenter (no presenter in headless mode)
  * - Renderer Context, Surface and the Renderer
  */
 class RendererInit {
@@ -30,11 +30,18 @@ public:
     mff::Vector2ui get_dimensions();
 
     /**
-     * Present buffer from RendererScreen to real screen
+     * Present buffer from RendererScreen to real screen (in headless mode just wait until it is
+     * rendered)
      * @return
      */
     boost::leaf::result<void> present();
 
+    /**
+     * Read back the rendered image from RendererScreen
+     * @return
+     */
+    boost::leaf::result<PixelData> read_pixels();
+
     /**
      * Init the renderer
      * @param window
@@ -44,6 +51,14 @@ public:
         const std::shared_ptr<mff::window::Window>& window
     );
 
+    /**
+     * Init the renderer without any window - renders only to RendererScreen from which can be the
+     * image read back
+     * @param dimensions dimensions of the rendered image
+     * @return
+     */
+    static boost::leaf::result<std::unique_ptr<RendererInit>> build_headless(mff::Vector2ui dimensions);
+
 private:
     RendererInit() = default;
 
@@ -0,0 +1,77 @@
+#include "./pixel_data.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include <fmt/format.h>
+
+std::array<std::uint8_t, 4> PixelData::get_rgba(std::uint32_t x, std::uint32_t y) const {
+    const auto* pixel = data.data() + (static_cast<std::size_t>(y) * width + x) * 4;
+
+    bool bgra = format == vk::Format::eB8G8R8A8Unorm || format == vk::Format::eB8G8R8A8Srgb;
+
+    if (bgra) {
+        return {pixel[2], pixel[1], pixel[0], pixel[3]};
+    }
+
+    return {pixel[0], pixel[1], pixel[2], pixel[3]};
+}
+
+/**
+ * Write header and the pixels with specified number of channels (3 - RGB, 4 - RGBA)
+ * @param file_name
+ * @param header
+ * @param pixels
+ * @param channels
+ * @return
+ */
+boost::leaf::result<void> write_netpbm(
+    const std::string& file_name,
+    const std::string& header,
+    const PixelData& pixels,
+    std::size_t channels
+) {
+    std::ofstream file(file_name, std::ios::out | std::ios::binary);
+    if (!file) return LEAF_NEW_ERROR();
+
+    file << header;
+
+    // convert whole rows so we do not write byte by byte
+    std::vector<char> row(pixels.width * channels);
+
+    for (std::uint32_t y = 0; y < pixels.height; y++) {
+        for (std::uint32_t x = 0; x < pixels.width; x++) {
+            auto rgba = pixels.get_rgba(x, y);
+            std::copy_n(std::begin(rgba), channels, std::begin(row) + x * channels);
+        }
+
+        file.write(row.data(), row.size());
+    }
+
+    if (!file) return LEAF_NEW_ERROR();
+
+    return {};
+}
+
+boost::leaf::result<void> write_ppm(const std::string& file_name, const PixelData& pixels) {
+    return write_netpbm(file_name, fmt::format("P6\n{} {}\n255\n", pixels.width, pixels.height), pixels, 3);
+}
+
+boost::leaf::result<void> write_pam(const std::string& file_name, const PixelData& pixels) {
+    return write_netpbm(
+        file_name,
+        fmt::format(
+            "P7\nWIDTH {}\nHEIGHT {}\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n",
+            pixels.width,
+            pixels.height),
+        pixels,
+        4);
+}
+
+boost::leaf::result<void> write_image(const std::string& file_name, const PixelData& pixels) {
+    if (std::filesystem::path(file_name).extension() == ".pam") {
+        return write_pam(file_name, pixels);
+    }
+
+    return write_ppm(file_name, pixels);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <mff/leaf.h>
+#include <mff/graphics/vulkan/vulkan.h>
+
+/**
+ * Pixels of image read back from GPU (tightly packed rows from top to bottom, 4 bytes per pixel)
+ */
+struct PixelData {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    // format of the pixels (R8G8B8A8 or B8G8R8A8 - unorm or srgb)
+    vk::Format format = vk::Format::eR8G8B8A8Unorm;
+    std::vector<std::uint8_t> data = {};
+
+    /**
+     * Get the channels of pixel in RGBA order (no matter the format)
+     * @param x
+     * @param y
+     * @return
+     */
+    std::array<std::uint8_t, 4> get_rgba(std::uint32_t x, std::uint32_t y) const;
+};
+
+/**
+ * Write the pixels to binary PPM file (P6, the alpha channel is dropped)
+ * @param file_name
+ * @param pixels
+ * @return
+ */
+boost::leaf::result<void> write_ppm(const std::string& file_name, const PixelData& pixels);
+
+/**
+ * Write the pixels to PAM file (P7 with RGB_ALPHA tuple type)
+ * @param file_name
+ * @param pixels
+ * @return
+ */
+boost::leaf::result<void> write_pam(const std::string& file_name, const PixelData& pixels);
+
+/**
+ * Write the pixels to PAM file if the file name ends with .pam, otherwise to PPM file
+ * @param file_name
+ * @param pixels
+ * @return
+ */
+boost::leaf::result<void> write_image(const std::string& file_name, const PixelData& pixels);
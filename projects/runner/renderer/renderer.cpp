@@ -1,30 +1,447 @@
 #include "./renderer.h"
 
+boost::leaf::result<void> Renderer::begin_frame(std::optional<mff::Vector4f> clear_color) {
+    if (recording_) return LEAF_NEW_ERROR();
+
+    frame_vertices_.clear();
+    frame_indices_.clear();
+    frame_draws_.clear();
+    frame_clear_color_ = clear_color;
+    recording_ = true;
+
+    return {};
+}
+
 boost::leaf::result<void> Renderer::draw(
-    const std::vector<Vertex>& vertexes, const std::vector<std::uint32_t>& indices, PushConstants push_constants
+    std::span<const Vertex> vertexes, std::span<const std::uint32_t> indices, PushConstants push_constants
 ) {
-    // request buffers to be of size
-    request_vertex_buffer(vertexes.size() * sizeof(Vertex));
-    request_index_buffer(indices.size() * sizeof(std::uint32_t));
+    DrawRecord record{DrawRange{0, static_cast<std::uint32_t>(indices.size()), 0}, push_constants};
+
+    return draw(vertexes, indices, std::span<const DrawRecord>(&record, 1));
+}
+
+boost::leaf::result<void> Renderer::draw(
+    std::span<const Vertex> vertexes,
+    std::span<const std::uint32_t> indices,
+    std::span<const DrawRecord> records
+) {
+    if (!recording_) return LEAF_NEW_ERROR();
+
+    auto first_index = static_cast<std::uint32_t>(frame_indices_.size());
+    auto vertex_offset = static_cast<std::int32_t>(frame_vertices_.size());
 
-    // copy vertices and indices to corresponding buffers on GPU
-    memcpy(vertex_buffer_->get_allocation_info().pMappedData, vertexes.data(), vertexes.size() * sizeof(Vertex));
-    memcpy(
-        index_buffer_->get_allocation_info().pMappedData,
-        indices.data(),
-        indices.size() * sizeof(std::uint32_t));
+    // just remember where the data of these draws start (they will be uploaded in end_frame)
+    for (const auto& record: records) {
+        frame_draws_.push_back(
+            DrawCommand{
+                DrawRange{
+                    first_index + record.range.first_index,
+                    record.range.index_count,
+                    vertex_offset + record.range.vertex_offset
+                },
+                record.constants,
+                record.pipeline
+            });
+    }
+
+    frame_vertices_.insert(std::end(frame_vertices_), std::begin(vertexes), std::end(vertexes));
+    frame_indices_.insert(std::end(frame_indices_), std::begin(indices), std::end(indices));
+
+    return {};
+}
+
+boost::leaf::result<void> Renderer::draw(GeometryHandle geometry, PushConstants push_constants) {
+    auto cached = get_geometry(geometry);
+    if (cached == nullptr) return LEAF_NEW_ERROR();
+
+    DrawRecord record{DrawRange{0, cached->index_count, 0}, push_constants};
+
+    return draw(geometry, std::span<const DrawRecord>(&record, 1));
+}
+
+boost::leaf::result<void> Renderer::draw(GeometryHandle geometry, std::span<const DrawRecord> records) {
+    if (!recording_ || get_geometry(geometry) == nullptr) return LEAF_NEW_ERROR();
+
+    for (const auto& record: records) {
+        frame_draws_.push_back(DrawCommand{record.range, record.constants, record.pipeline, geometry});
+    }
+
+    return {};
+}
+
+boost::leaf::result<void> Renderer::end_frame() {
+    if (!recording_) return LEAF_NEW_ERROR();
+    recording_ = false;
+
+    if (frame_draws_.empty() && pending_uploads_.empty() && !frame_clear_color_) return {};
+
+    // the region of ring (and command buffer) could be still used by the frame which used them
+    // last time (the other frames can be still rendered)
+    LEAF_CHECK(wait_frame(frame_index_));
+    auto& frame = frames_[frame_index_];
+
+    if (indirect_) {
+        build_indirect_commands();
+    }
+
+    LEAF_CHECK(write_frame_data());
 
     // get a command buffer and reset it
-    vk::CommandBuffer buffer = command_buffer_alloc_->get_handle();
+    vk::CommandBuffer buffer = frame.command_buffer->get_handle();
+    LEAF_CHECK(mff::to_result(buffer.reset({})));
+    LEAF_CHECK(mff::to_result(buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit))));
+    record_uploads(buffer);
+    record_frame(buffer);
+    LEAF_CHECK(mff::to_result(buffer.end()));
+
+    // submit the commands - we will wait for them only when we really need to
+    vk::PipelineStageFlags wait_flag = vk::PipelineStageFlagBits::eAllCommands;
+    vk::SubmitInfo submit_info(0, nullptr, &wait_flag, 1, &buffer, 0, nullptr);
+    LEAF_CHECK(mff::to_result(graphics_queue_->get_handle().submit({submit_info}, frame.fence->get_handle())));
+    frame.in_flight = true;
+
+    // the frames are finished in order, so the released buffers are free when this frame is
+    for (auto& released: released_buffers_) {
+        frame.released_buffers.push_back(std::move(released));
+    }
+    released_buffers_.clear();
+
+    frame_index_ = (frame_index_ + 1) % frames_.size();
+
+    return {};
+}
+
+boost::leaf::result<void> Renderer::wait() {
+    for (std::uint32_t i = 0; i < frames_.size(); i++) {
+        LEAF_CHECK(wait_frame(i));
+    }
+
+    // nothing can use them anymore
+    released_buffers_.clear();
+
+    return {};
+}
+
+boost::leaf::result<void> Renderer::wait_frame(std::uint32_t frame_index) {
+    auto& frame = frames_[frame_index];
+    if (!frame.in_flight) return {};
+
+    auto device = get_context()->get_device()->get_handle();
+
+    LEAF_CHECK(mff::to_result(
+        device.waitForFences({frame.fence->get_handle()}, true, std::numeric_limits<std::uint64_t>::max())));
+    device.resetFences({frame.fence->get_handle()});
+    frame.in_flight = false;
+    frame.released_buffers.clear();
+
+    return {};
+}
+
+boost::leaf::result<PixelData> Renderer::read_pixels() {
+    // the image has to be rendered
+    LEAF_CHECK(wait());
+
+    auto width = surface_->get_width();
+    auto height = surface_->get_height();
+    auto format = get_context()->get_color_attachment_format();
+    vk::DeviceSize size = static_cast<vk::DeviceSize>(width) * height * 4;
+
+    if (readback_buffer_ == nullptr || readback_buffer_->get_size() < size) {
+        LEAF_AUTO_TO(
+            readback_buffer_,
+            create_buffer(size, vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_TO_CPU));
+    }
+
+    auto image = surface_->get_color_image()->get_inner_image().get_image()->get_handle();
+    vk::ImageSubresourceRange color_range(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+    // nothing is in flight so we can use command buffer and fence of any frame
+    auto& frame = frames_[frame_index_];
+    vk::CommandBuffer buffer = frame.command_buffer->get_handle();
     LEAF_CHECK(mff::to_result(buffer.reset({})));
     LEAF_CHECK(mff::to_result(buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit))));
 
+    // the image is in color attachment layout between frames
+    buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        {},
+        {},
+        {vk::ImageMemoryBarrier(
+            vk::AccessFlagBits::eColorAttachmentWrite,
+            vk::AccessFlagBits::eTransferRead,
+            vk::ImageLayout::eColorAttachmentOptimal,
+            vk::ImageLayout::eTransferSrcOptimal,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            image,
+            color_range)});
+
+    buffer.copyImageToBuffer(
+        image,
+        vk::ImageLayout::eTransferSrcOptimal,
+        readback_buffer_->get_buffer(),
+        {vk::BufferImageCopy(
+            0,
+            0,
+            0,
+            vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1),
+            {0, 0, 0},
+            {width, height, 1})});
+
+    // return the image back and make the copied data visible to host
+    buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eHost,
+        {},
+        {vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead)},
+        {},
+        {vk::ImageMemoryBarrier(
+            vk::AccessFlagBits::eTransferRead,
+            vk::AccessFlagBits::eColorAttachmentWrite,
+            vk::ImageLayout::eTransferSrcOptimal,
+            vk::ImageLayout::eColorAttachmentOptimal,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            image,
+            color_range)});
+
+    LEAF_CHECK(mff::to_result(buffer.end()));
+
+    vk::PipelineStageFlags wait_flag = vk::PipelineStageFlagBits::eAllCommands;
+    vk::SubmitInfo submit_info(0, nullptr, &wait_flag, 1, &buffer, 0, nullptr);
+    LEAF_CHECK(mff::to_result(graphics_queue_->get_handle().submit({submit_info}, frame.fence->get_handle())));
+    frame.in_flight = true;
+    LEAF_CHECK(wait_frame(frame_index_));
+
+    PixelData result = {width, height, format, std::vector<std::uint8_t>(size)};
+    memcpy(result.data.data(), readback_buffer_->get_allocation_info().pMappedData, size);
+
+    return result;
+}
+
+boost::leaf::result<GeometryHandle> Renderer::upload(
+    std::span<const Vertex> vertexes,
+    std::span<const std::uint32_t> indices
+) {
+    auto vertices_size = vertexes.size() * sizeof(Vertex);
+    auto indices_size = indices.size() * sizeof(std::uint32_t);
+
+    CachedGeometry geometry = {};
+    geometry.index_count = indices.size();
+
+    // the final buffers live only on GPU
+    LEAF_AUTO_TO(
+        geometry.vertex_buffer,
+        create_buffer(
+            std::max<vk::DeviceSize>(vertices_size, 1),
+            vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            VMA_MEMORY_USAGE_GPU_ONLY));
+    LEAF_AUTO_TO(
+        geometry.index_buffer,
+        create_buffer(
+            std::max<vk::DeviceSize>(indices_size, 1),
+            vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            VMA_MEMORY_USAGE_GPU_ONLY));
+
+    // remember the data - they will be copied through staging buffer with next submit
+    auto add_pending = [&](vk::Buffer destination, const void* data, std::size_t size) {
+        if (size == 0) return;
+
+        auto offset = staging_data_.size();
+        staging_data_.resize(offset + size);
+        memcpy(staging_data_.data() + offset, data, size);
+        pending_uploads_.push_back(PendingUpload{destination, offset, size});
+    };
+
+    add_pending(geometry.vertex_buffer->get_buffer(), vertexes.data(), vertices_size);
+    add_pending(geometry.index_buffer->get_buffer(), indices.data(), indices_size);
+
+    // reuse released slots
+    if (!free_geometries_.empty()) {
+        auto index = free_geometries_.back();
+        free_geometries_.pop_back();
+        geometry.generation = geometries_[index].generation;
+        geometries_[index] = std::move(geometry);
+
+        return GeometryHandle{index, geometries_[index].generation};
+    }
+
+    geometries_.push_back(std::move(geometry));
+
+    return GeometryHandle{static_cast<std::uint32_t>(geometries_.size() - 1), 0};
+}
+
+void Renderer::release(GeometryHandle geometry) {
+    // released twice (the slot could already hold another geometry)
+    if (get_geometry(geometry) == nullptr) return;
+
+    auto& cached = geometries_[geometry.index];
+
+    // the geometry could be released before its copy was recorded (wait can destroy the released
+    // buffers before the next submit, so the copy must not be recorded at all)
+    auto vertex_buffer = cached.vertex_buffer->get_buffer();
+    auto index_buffer = cached.index_buffer->get_buffer();
+    std::erase_if(pending_uploads_, [&](const PendingUpload& upload) {
+        return upload.destination == vertex_buffer || upload.destination == index_buffer;
+    });
+    if (pending_uploads_.empty()) staging_data_.clear();
+
+    // the buffers could still be used by frame in flight
+    released_buffers_.push_back(std::move(cached.vertex_buffer));
+    released_buffers_.push_back(std::move(cached.index_buffer));
+    cached.index_count = 0;
+    cached.generation++;
+    free_geometries_.push_back(geometry.index);
+}
+
+const Renderer::CachedGeometry* Renderer::get_geometry(GeometryHandle geometry) const {
+    if (geometry.index >= geometries_.size()) return nullptr;
+
+    const auto& cached = geometries_[geometry.index];
+    if (cached.generation != geometry.generation || cached.vertex_buffer == nullptr) return nullptr;
+
+    return &cached;
+}
+
+void Renderer::build_indirect_commands() {
+    indirect_commands_.clear();
+    draw_data_.clear();
+    indirect_batches_.clear();
+
+    for (const auto& draw: frame_draws_) {
+        // released in the middle of frame (the slot could be even reused by another geometry)
+        if (draw.geometry && get_geometry(*draw.geometry) == nullptr) continue;
+
+        // the first instance is the index of draw data in the storage buffer
+        auto draw_index = static_cast<std::uint32_t>(indirect_commands_.size());
+        indirect_commands_.emplace_back(
+            draw.range.index_count,
+            1,
+            draw.range.first_index,
+            draw.range.vertex_offset,
+            draw_index);
+        draw_data_.push_back(
+            DrawData{draw.push_constants.color, draw.push_constants.transform, draw.push_constants.scale});
+
+        // merge with the previous draw if it uses the same geometry and pipeline
+        auto same_batch = [&](const IndirectBatch& batch) {
+            if (batch.pipeline != draw.pipeline) return false;
+            if (batch.geometry.has_value() != draw.geometry.has_value()) return false;
+
+            return !draw.geometry || batch.geometry->index == draw.geometry->index;
+        };
+
+        if (!indirect_batches_.empty() && same_batch(indirect_batches_.back())) {
+            indirect_batches_.back().draw_count++;
+        } else {
+            indirect_batches_.push_back(IndirectBatch{draw.geometry, draw.pipeline, draw_index, 1});
+        }
+    }
+}
+
+boost::leaf::result<void> Renderer::write_frame_data() {
+    auto draw_data_size = draw_data_.size() * sizeof(DrawData);
+    auto indirect_size = indirect_commands_.size() * sizeof(vk::DrawIndexedIndirectCommand);
+    auto vertices_size = frame_vertices_.size() * sizeof(Vertex);
+    auto indices_size = frame_indices_.size() * sizeof(std::uint32_t);
+
+    LEAF_CHECK(request_ring(
+        UploadRing::aligned_size(draw_data_size)
+            + UploadRing::aligned_size(indirect_size)
+            + UploadRing::aligned_size(vertices_size)
+            + UploadRing::aligned_size(indices_size)
+            + UploadRing::aligned_size(staging_data_.size())));
+
+    // the region is big enough for everything, so none of the following allocations can fail
+    ring_->begin_region(frame_index_);
+
+    // draw data has to be first - the descriptor covers one region starting at dynamic offset
+    frame_draw_data_offset_ = ring_->push(draw_data_.data(), draw_data_size)->offset;
+    frame_indirect_offset_ = ring_->push(indirect_commands_.data(), indirect_size)->offset;
+    frame_vertex_offset_ = ring_->push(frame_vertices_.data(), vertices_size)->offset;
+    frame_index_offset_ = ring_->push(frame_indices_.data(), indices_size)->offset;
+    frame_staging_offset_ = ring_->push(staging_data_.data(), staging_data_.size())->offset;
+
+    return {};
+}
+
+boost::leaf::result<void> Renderer::request_ring(vk::DeviceSize required_size) {
+    if (ring_ != nullptr && ring_->get_region_size() >= required_size) return {};
+
+    // the ring could be used by any of the frames in flight
+    LEAF_CHECK(wait());
+
+    auto region_size = ring_ == nullptr
+        ? required_size
+        : std::max(required_size, 2 * ring_->get_region_size());
+
+    logger::main->debug("Renderer requesting bigger upload ring with regions of size {}", region_size);
+    LEAF_AUTO_TO(
+        ring_,
+        UploadRing::build(
+            get_context()->get_device(),
+            region_size,
+            frames_.size(),
+            vk::BufferUsageFlagBits::eVertexBuffer
+                | vk::BufferUsageFlagBits::eIndexBuffer
+                | vk::BufferUsageFlagBits::eIndirectBuffer
+                | vk::BufferUsageFlagBits::eStorageBuffer
+                | vk::BufferUsageFlagBits::eTransferSrc));
+
+    // point the descriptor set to the new ring (no frame is in flight so we can update it)
+    if (indirect_) {
+        vk::DescriptorBufferInfo buffer_info(ring_->get_buffer(), 0, ring_->get_region_size());
+        vk::WriteDescriptorSet write(
+            draw_data_set_,
+            0,
+            0,
+            1,
+            vk::DescriptorType::eStorageBufferDynamic,
+            nullptr,
+            &buffer_info);
+
+        get_context()->get_device()->get_handle().updateDescriptorSets({write}, {});
+    }
+
+    return {};
+}
+
+void Renderer::record_uploads(vk::CommandBuffer buffer) {
+    if (pending_uploads_.empty()) return;
+
+    for (const auto& upload: pending_uploads_) {
+        buffer.copyBuffer(
+            ring_->get_buffer(),
+            upload.destination,
+            {vk::BufferCopy(frame_staging_offset_ + upload.staging_offset, 0, upload.size)});
+    }
+
+    // uploaded data has to be visible to vertex input
+    buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eVertexInput,
+        {},
+        {vk::MemoryBarrier(
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead)},
+        {},
+        {});
+
+    logger::main->debug("Renderer uploaded {} bytes of geometry", staging_data_.size());
+
+    staging_data_.clear();
+    pending_uploads_.clear();
+}
+
+void Renderer::record_frame(vk::CommandBuffer buffer) {
     std::vector<vk::ClearValue> clear_values = {
         vk::ClearValue(vk::ClearColorValue(std::array<std::uint32_t, 4>{0, 0, 0, 0})),
         vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0))
     };
 
-    // start render oass
+    // start render pass
     buffer.beginRenderPass(
         vk::RenderPassBeginInfo(
             get_context()->get_renderpass()->get_handle(),
@@ -42,46 +459,128 @@ boost::leaf::result<void> Renderer::draw(
         {vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(surface_->get_width(), surface_->get_height()))}
     );
 
-    // bind the buffers so they can be rendered
-    auto vb = vertex_buffer_->get_buffer();
-    buffer.bindVertexBuffers(0, {vb}, {0});
-    auto ib = index_buffer_->get_buffer();
-    buffer.bindIndexBuffer(ib, 0, vk::IndexType::eUint32);
+    vk::ClearRect clear_rect(vk::Rect2D({0, 0}, {surface_->get_width(), surface_->get_height()}), 0, 1);
 
-    // update the push constants
-    buffer.pushConstants(
-        get_context()->get_pipeline_layout(),
-        vk::ShaderStageFlagBits::eVertex,
-        0,
-        sizeof(PushConstants),
-        &push_constants
-    );
+    // stencil-then-cover fills expect the stencil to be zero (the cover resets it back)
+    buffer.clearAttachments(
+        {vk::ClearAttachment(vk::ImageAspectFlagBits::eStencil, 0, clear_values[1])},
+        {clear_rect});
 
-    // bind pipelines
-    buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, get_context()->get_over_pipeline());
-    buffer.setStencilCompareMask(vk::StencilFaceFlagBits::eFrontAndBack, kSTENCIL_CLIP_BIT);
-    // draw the indices
-    buffer.drawIndexed(indices.size(), 1, 0, 0, 0);
-    buffer.endRenderPass();
-    LEAF_CHECK(mff::to_result(buffer.end()));
+    if (frame_clear_color_) {
+        const auto& color = frame_clear_color_.value();
 
-    // submit the commands and wait for results
-    // TODO: do this "asynchronously"
-    vk::PipelineStageFlags wait_flag = vk::PipelineStageFlagBits::eAllCommands;
-    vk::SubmitInfo submit_info(0, nullptr, &wait_flag, 1, &buffer, 0, nullptr);
-    graphics_queue_->get_handle().submit({submit_info}, fence_->get_handle());
+        buffer.clearAttachments(
+            {vk::ClearAttachment(
+                vk::ImageAspectFlagBits::eColor,
+                0,
+                vk::ClearValue(vk::ClearColorValue(std::array<float, 4>{color[0], color[1], color[2], color[3]})))},
+            {clear_rect});
+    }
 
-    get_context()->get_device()
-        ->get_handle()
-        .waitForFences({fence_->get_handle()}, true, std::numeric_limits<std::uint64_t>::max());
-    get_context()->get_device()->get_handle().resetFences({fence_->get_handle()});
+    // bind the pipeline (only when it changes)
+    std::optional<PipelineKind> bound_pipeline = std::nullopt;
+    auto bind_pipeline = [&](PipelineKind kind) {
+        if (bound_pipeline == kind) return;
 
-    return {};
+        buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, get_context()->get_pipeline(kind, indirect_));
+        bound_pipeline = kind;
+
+        if (kind == PipelineKind::Over || kind == PipelineKind::OverStrip) {
+            buffer.setStencilCompareMask(vk::StencilFaceFlagBits::eFrontAndBack, kSTENCIL_CLIP_BIT);
+        }
+    };
+
+    // bind the buffers so they can be rendered (only when they change)
+    std::optional<vk::Buffer> bound_vertex_buffer = std::nullopt;
+    auto bind_buffers = [&](const std::optional<GeometryHandle>& geometry_handle) {
+        auto vb = ring_->get_buffer();
+        auto ib = ring_->get_buffer();
+        vk::DeviceSize vb_offset = frame_vertex_offset_;
+        vk::DeviceSize ib_offset = frame_index_offset_;
+
+        // uploaded geometry or the frame data in ring
+        if (geometry_handle) {
+            const auto& geometry = *get_geometry(*geometry_handle);
+            vb = geometry.vertex_buffer->get_buffer();
+            ib = geometry.index_buffer->get_buffer();
+            vb_offset = 0;
+            ib_offset = 0;
+        }
+
+        if (bound_vertex_buffer == vb) return;
+
+        buffer.bindVertexBuffers(0, {vb}, {vb_offset});
+        buffer.bindIndexBuffer(ib, ib_offset, vk::IndexType::eUint32);
+        bound_vertex_buffer = vb;
+    };
+
+    if (indirect_) {
+        // bind the per draw data (same for all pipelines)
+        buffer.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics,
+            get_context()->get_pipeline_layout(),
+            0,
+            {draw_data_set_},
+            {static_cast<std::uint32_t>(frame_draw_data_offset_)});
+
+        auto multi_draw = get_context()->supports_multi_draw_indirect();
+        auto stride = static_cast<std::uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+
+        for (const auto& batch: indirect_batches_) {
+            bind_pipeline(batch.pipeline);
+            bind_buffers(batch.geometry);
+
+            // whole batch by one call if possible
+            if (multi_draw) {
+                buffer.drawIndexedIndirect(
+                    ring_->get_buffer(),
+                    frame_indirect_offset_ + batch.first_draw * stride,
+                    batch.draw_count,
+                    stride);
+                continue;
+            }
+
+            for (std::uint32_t i = 0; i < batch.draw_count; i++) {
+                buffer.drawIndexedIndirect(
+                    ring_->get_buffer(),
+                    frame_indirect_offset_ + (batch.first_draw + i) * stride,
+                    1,
+                    stride);
+            }
+        }
+
+        buffer.endRenderPass();
+
+        return;
+    }
+
+    for (const auto& draw: frame_draws_) {
+        // released in the middle of frame (the slot could be even reused by another geometry)
+        if (draw.geometry && get_geometry(*draw.geometry) == nullptr) continue;
+
+        bind_pipeline(draw.pipeline);
+        bind_buffers(draw.geometry);
+
+        // update the push constants
+        buffer.pushConstants(
+            get_context()->get_pipeline_layout(),
+            vk::ShaderStageFlagBits::eVertex,
+            0,
+            sizeof(PushConstants),
+            &draw.push_constants
+        );
+
+        // draw the indices
+        buffer.drawIndexed(draw.range.index_count, 1, draw.range.first_index, draw.range.vertex_offset, 0);
+    }
+
+    buffer.endRenderPass();
 }
 
 boost::leaf::result<std::unique_ptr<Renderer>> Renderer::build(
     RendererSurface* surface,
-    mff::vulkan::SharedQueue graphics_queue
+    mff::vulkan::SharedQueue graphics_queue,
+    RendererOptions options
 ) {
     logger::main->debug("Building Renderer");
     struct enable_Renderer : public Renderer {};
@@ -92,13 +591,44 @@ boost::leaf::result<std::unique_ptr<Renderer>> Renderer::build(
 
     auto device = surface->get_context()->get_device();
 
-    // prepare buffers, fence and command buffers
-    LEAF_CHECK(result->request_vertex_buffer(1024));
-    LEAF_CHECK(result->request_index_buffer(1024));
-    LEAF_AUTO_TO(result->fence_, mff::vulkan::Fence::build(device, false)); // TODO: use pool
+    // prepare resources of all frames in flight
+    auto frames_in_flight = std::max<std::uint32_t>(options.frames_in_flight, 1);
     LEAF_AUTO(pool, device->get_command_pool(graphics_queue->get_queue_family()));
-    LEAF_AUTO(cmd_buffs, pool->allocate(1, false));
-    result->command_buffer_alloc_ = std::move(cmd_buffs[0]);
+    LEAF_AUTO(cmd_buffs, pool->allocate(frames_in_flight, false));
+
+    for (auto& cmd_buff: cmd_buffs) {
+        LEAF_AUTO(fence, mff::vulkan::Fence::from_pool(device));
+        result->frames_.push_back(Frame{std::move(cmd_buff), std::move(fence)});
+    }
+
+    // descriptor set with the per draw data for indirect drawing
+    result->indirect_ = options.indirect && surface->get_context()->supports_indirect();
+
+    if (result->indirect_) {
+        std::vector<vk::DescriptorPoolSize> pool_sizes = {vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 1)};
+
+        LEAF_AUTO_TO(
+            result->descriptor_pool_,
+            mff::to_result(
+                device->get_handle().createDescriptorPoolUnique(
+                    vk::DescriptorPoolCreateInfo({}, 1, pool_sizes.size(), pool_sizes.data()))));
+
+        auto set_layout = surface->get_context()->get_draw_data_set_layout();
+        LEAF_AUTO(
+            sets,
+            mff::to_result(
+                device->get_handle().allocateDescriptorSets(
+                    vk::DescriptorSetAllocateInfo(result->descriptor_pool_.get(), 1, &set_layout))));
+        result->draw_data_set_ = sets[0];
+    }
+
+    // the descriptor set has to exist before the ring is built
+    LEAF_CHECK(result->request_ring(options.ring_size / frames_in_flight));
+
+    logger::main->debug(
+        "Renderer uses {} draws with {} frames in flight",
+        result->indirect_ ? "indirect" : "direct",
+        frames_in_flight);
 
     return result;
 }
@@ -107,7 +637,11 @@ RendererContext* Renderer::get_context() {
     return surface_->get_context();
 }
 
-boost::leaf::result<vma::UniqueBuffer> Renderer::create_buffer(vk::DeviceSize size, vk::BufferUsageFlags usage) {
+boost::leaf::result<vma::UniqueBuffer> Renderer::create_buffer(
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    VmaMemoryUsage memory_usage
+) {
     auto buffer_info = vk::BufferCreateInfo(
         {},
         size,
@@ -116,29 +650,12 @@ boost::leaf::result<vma::UniqueBuffer> Renderer::create_buffer(vk::DeviceSize si
     );
 
     VmaAllocationCreateInfo allocation_info = {};
-    // TODO: consider using some other type of memory
-    // but most probably this is the best we can get, because everytime we upload it with new data
-    allocation_info.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-    allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocation_info.usage = memory_usage;
 
-    return get_context()->get_device()->get_allocator()->create_buffer(buffer_info, allocation_info);
-}
-
-boost::leaf::result<void> Renderer::request_vertex_buffer(vk::DeviceSize required_size) {
-    if (vertex_buffer_ != nullptr && vertex_buffer_->get_size() >= required_size) return {};
-
-    logger::main->debug("Renderer requesting bigger vertex buffer of size {}", required_size);
-    LEAF_AUTO_TO(vertex_buffer_, create_buffer(required_size, vk::BufferUsageFlagBits::eVertexBuffer));
+    // everything which is not only on GPU is going to be written by us
+    if (memory_usage != VMA_MEMORY_USAGE_GPU_ONLY) {
+        allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    }
 
-    return {};
+    return get_context()->get_device()->get_allocator()->create_buffer(buffer_info, allocation_info);
 }
-
-
-boost::leaf::result<void> Renderer::request_index_buffer(vk::DeviceSize required_size) {
-    if (index_buffer_ != nullptr && index_buffer_->get_size() >= required_size) return {};
-
-    logger::main->debug("Renderer requesting bigger index buffer of size {}", required_size);
-    LEAF_AUTO_TO(index_buffer_, create_buffer(required_size, vk::BufferUsageFlagBits::eIndexBuffer));
-
-    return {};
-}
\ No newline at end of file
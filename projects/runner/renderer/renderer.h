@@ -1,40 +1,185 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <span>
 
 #include <mff/leaf.h>
 
+#include "./pixel_data.h"
 #include "./renderer_context.h"
 #include "./renderer_surface.h"
+#include "./upload_ring.h"
+
+/**
+ * Handle to geometry (vertices + indices) uploaded to device local memory by Renderer::upload
+ */
+struct GeometryHandle {
+    std::uint32_t index = 0;
+    // the slots of released geometry are reused, the handle is valid only while the generation
+    // matches the one of its slot
+    std::uint32_t generation = 0;
+};
+
+/**
+ * Range of indexed geometry drawn by one draw call
+ */
+struct DrawRange {
+    std::uint32_t first_index = 0;
+    std::uint32_t index_count = 0;
+    // added to every index (so the indices can be relative to the start of the record)
+    std::int32_t vertex_offset = 0;
+};
+
+/**
+ * Part of geometry drawn by one draw call (with its own push constants)
+ */
+struct DrawRecord {
+    DrawRange range = {};
+    PushConstants constants = {};
+    PipelineKind pipeline = PipelineKind::Over;
+};
+
+/**
+ * Options of Renderer
+ */
+struct RendererOptions {
+    /**
+     * Should the frames be drawn by indirect draws (per draw data are read from storage buffer)?
+     * Used only if supported by device (otherwise falls back to one draw per record).
+     */
+    bool indirect = true;
+
+    /**
+     * How many frames can be rendered by GPU while we are recording the next one
+     */
+    std::uint32_t frames_in_flight = 2;
+
+    /**
+     * Initial size of the ring from which the frames allocate their streamed data (vertices,
+     * indices, draw data and staging data of uploads). Every frame in flight gets equal part of
+     * it, the ring grows when the frame does not fit (which requires waiting for all frames).
+     */
+    vk::DeviceSize ring_size = 8 * 1024 * 1024;
+};
 
 /**
  * Renderer is class which takes RendererSurface and graphics queue on which to execute commands
  * and present you with commands to do simple rendering
  *
  * The rendering is done using with provided vertices, indices and push constants (color, transform)
+ * and it is batched by frames (begin_frame, draw..., end_frame) so the whole frame is submitted at
+ * once. Multiple frames can be in flight - every frame streams its data through its own region of
+ * the upload ring, so the next frame can be recorded while the previous ones are rendered.
+ *
+ * Geometry which does not change can be uploaded once (upload) to device local memory and then
+ * drawn using the returned handle without any further copying
+ *
+ * When indirect drawing is enabled, the colors and transforms are written to storage buffer and all
+ * consecutive draws of the same geometry are issued by one vkCmdDrawIndexedIndirect
  */
 class Renderer {
 public:
     /**
-     * Render triangles with provided vertices, indices and push_constants
+     * Start recording of new frame - all the following draws are going to be recorded into one
+     * command buffer (and one render pass) and submitted together in end_frame
+     * @param clear_color if specified the image is cleared to this color at the start of frame
+     *                    (otherwise the frame is drawn over the previous one)
+     * @return
+     */
+    boost::leaf::result<void> begin_frame(std::optional<mff::Vector4f> clear_color = std::nullopt);
+
+    /**
+     * Queue triangles with provided vertices, indices and push_constants to the current frame
      * @param vertexes
      * @param indices
      * @param push_constants
      * @return
      */
     boost::leaf::result<void> draw(
-        const std::vector<Vertex>& vertexes, const std::vector<std::uint32_t>& indices, PushConstants push_constants
+        std::span<const Vertex> vertexes, std::span<const std::uint32_t> indices, PushConstants push_constants
+    );
+
+    /**
+     * Queue multiple records sharing the same vertices and indices to the current frame (the
+     * data are copied only once)
+     * @param vertexes
+     * @param indices
+     * @param records
+     * @return
+     */
+    boost::leaf::result<void> draw(
+        std::span<const Vertex> vertexes,
+        std::span<const std::uint32_t> indices,
+        std::span<const DrawRecord> records
+    );
+
+    /**
+     * Queue triangles of already uploaded geometry to the current frame
+     * @param geometry
+     * @param push_constants
+     * @return
+     */
+    boost::leaf::result<void> draw(GeometryHandle geometry, PushConstants push_constants);
+
+    /**
+     * Queue ranges of already uploaded geometry to the current frame (the geometry is bound only
+     * once for all of them)
+     * @param geometry
+     * @param records
+     * @return
+     */
+    boost::leaf::result<void> draw(GeometryHandle geometry, std::span<const DrawRecord> records);
+
+    /**
+     * Upload all queued data, record the command buffer and submit it (without waiting for the
+     * result)
+     * @return
+     */
+    boost::leaf::result<void> end_frame();
+
+    /**
+     * Wait until all the submitted frames are rendered (no-op if there is nothing in flight)
+     * @return
+     */
+    boost::leaf::result<void> wait();
+
+    /**
+     * Read back the color image of the surface (waits for all submitted frames)
+     * @return
+     */
+    boost::leaf::result<PixelData> read_pixels();
+
+    /**
+     * Upload geometry to device local memory. The copy (through staging buffer) is recorded at
+     * the start of next submitted frame, so the handle can be used right away.
+     * @param vertexes
+     * @param indices
+     * @return handle to the uploaded geometry
+     */
+    boost::leaf::result<GeometryHandle> upload(
+        std::span<const Vertex> vertexes,
+        std::span<const std::uint32_t> indices
     );
 
+    /**
+     * Release the uploaded geometry (the memory is freed after the frames using it are rendered).
+     * The handle (and all its copies) is not valid after release, even if its slot is reused.
+     * @param geometry
+     */
+    void release(GeometryHandle geometry);
+
     /**
      * Build the renderer
      * @param surface surface on which to render
      * @param graphics_queue queue to use for rendering
+     * @param options
      * @return
      */
     static boost::leaf::result<std::unique_ptr<Renderer>> build(
         RendererSurface* surface,
-        mff::vulkan::SharedQueue graphics_queue
+        mff::vulkan::SharedQueue graphics_queue,
+        RendererOptions options = {}
     );
 
     /**
@@ -50,31 +195,155 @@ private:
      * Helper function to create buffer
      * @param size the size of requested buffer
      * @param usage how is the buffer going to be used
+     * @param memory_usage where should the buffer live (mapped unless GPU only)
      * @return
      */
-    boost::leaf::result<vma::UniqueBuffer> create_buffer(vk::DeviceSize size, vk::BufferUsageFlags usage);
+    boost::leaf::result<vma::UniqueBuffer> create_buffer(
+        vk::DeviceSize size,
+        vk::BufferUsageFlags usage,
+        VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU
+    );
 
     /**
-     * Request the vertex buffer to be sized at_least of required_size
+     * Request the ring regions to be sized at least of required_size (waits for all the frames
+     * when the ring has to grow)
      * @param required_size
      * @return
      */
-    boost::leaf::result<void> request_vertex_buffer(vk::DeviceSize required_size);
+    boost::leaf::result<void> request_ring(vk::DeviceSize required_size);
 
     /**
-     * Request the index buffer to be sized at_least of required_size
-     * @param required_size
+     * Wait until the frame is rendered and free the resources it was using
+     * @param frame
      * @return
      */
-    boost::leaf::result<void> request_index_buffer(vk::DeviceSize required_size);
+    boost::leaf::result<void> wait_frame(std::uint32_t frame);
+
+    /**
+     * Build indirect commands and draw data of queued draws
+     */
+    void build_indirect_commands();
+
+    /**
+     * Write all the streamed data of current frame (vertices, indices, indirect commands, draw
+     * data and staging data) to its region of the ring
+     * @return
+     */
+    boost::leaf::result<void> write_frame_data();
+
+    /**
+     * Copy pending uploads to the ring and record their copies to the command buffer
+     * @param buffer
+     */
+    void record_uploads(vk::CommandBuffer buffer);
+
+    /**
+     * Record all queued draws to the command buffer
+     * @param buffer
+     */
+    void record_frame(vk::CommandBuffer buffer);
+
+    /**
+     * One queued draw (ranges into the frame vertex and index data or into uploaded geometry)
+     */
+    struct DrawCommand {
+        DrawRange range;
+        PushConstants push_constants;
+        PipelineKind pipeline = PipelineKind::Over;
+        std::optional<GeometryHandle> geometry = std::nullopt;
+    };
+
+    /**
+     * Consecutive indirect draws using the same geometry and pipeline (issued by one indirect
+     * draw call)
+     */
+    struct IndirectBatch {
+        std::optional<GeometryHandle> geometry;
+        PipelineKind pipeline;
+        std::uint32_t first_draw;
+        std::uint32_t draw_count;
+    };
+
+    /**
+     * Geometry living in device local memory
+     */
+    struct CachedGeometry {
+        vma::UniqueBuffer vertex_buffer;
+        vma::UniqueBuffer index_buffer;
+        std::uint32_t index_count;
+        // incremented on release (the handles to previous geometry of the slot are stale)
+        std::uint32_t generation = 0;
+    };
+
+    /**
+     * Get the uploaded geometry of handle
+     * @param geometry
+     * @return the geometry or nullptr if the handle was released (or is not valid at all)
+     */
+    const CachedGeometry* get_geometry(GeometryHandle geometry) const;
+
+    /**
+     * Copy from staging data to device local buffer waiting for next submit
+     */
+    struct PendingUpload {
+        vk::Buffer destination;
+        vk::DeviceSize staging_offset;
+        vk::DeviceSize size;
+    };
+
+    /**
+     * Resources of one frame in flight (it uses the region of upload ring with the same index)
+     */
+    struct Frame {
+        mff::vulkan::UniqueCommandPoolAllocation command_buffer;
+        mff::vulkan::UniquePooledFence fence;
+        bool in_flight = false;
+        // released buffers which could be used by this frame or the frames before it
+        std::vector<vma::UniqueBuffer> released_buffers = {};
+    };
 
     RendererSurface* surface_;
 
-    vma::UniqueBuffer vertex_buffer_;
-    vma::UniqueBuffer index_buffer_;
+    // frames in flight (frame_index_ is the one which is going to be recorded next)
+    std::vector<Frame> frames_ = {};
+    std::uint32_t frame_index_ = 0;
+
+    // streamed data of all frames
+    std::unique_ptr<UploadRing> ring_;
+    // where are the data of the currently recorded frame in the ring
+    vk::DeviceSize frame_vertex_offset_ = 0;
+    vk::DeviceSize frame_index_offset_ = 0;
+    vk::DeviceSize frame_indirect_offset_ = 0;
+    vk::DeviceSize frame_draw_data_offset_ = 0;
+    vk::DeviceSize frame_staging_offset_ = 0;
+
+    // data of the currently recorded frame
+    std::vector<Vertex> frame_vertices_ = {};
+    std::vector<std::uint32_t> frame_indices_ = {};
+    std::vector<DrawCommand> frame_draws_ = {};
+    std::optional<mff::Vector4f> frame_clear_color_ = std::nullopt;
+    bool recording_ = false;
+
+    // indirect drawing (used only if indirect_ is set)
+    bool indirect_ = false;
+    std::vector<vk::DrawIndexedIndirectCommand> indirect_commands_ = {};
+    std::vector<DrawData> draw_data_ = {};
+    std::vector<IndirectBatch> indirect_batches_ = {};
+    vk::UniqueDescriptorPool descriptor_pool_;
+    vk::DescriptorSet draw_data_set_;
+
+    // uploaded geometry (released slots are reused)
+    std::vector<CachedGeometry> geometries_ = {};
+    std::vector<std::uint32_t> free_geometries_ = {};
+    // released buffers which could still be used by submitted frames (they are moved to the next
+    // submitted frame)
+    std::vector<vma::UniqueBuffer> released_buffers_ = {};
+
+    std::vector<char> staging_data_ = {};
+    std::vector<PendingUpload> pending_uploads_ = {};
 
-    mff::vulkan::UniqueCommandPoolAllocation command_buffer_alloc_;
-    mff::vulkan::UniqueFence fence_;
+    // host visible buffer to which is the color image copied by read_pixels
+    vma::UniqueBuffer readback_buffer_;
 
     mff::vulkan::SharedQueue graphics_queue_;
-};
\ No newline at end of file
+};
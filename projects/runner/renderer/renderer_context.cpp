@@ -1,5 +1,7 @@
 #include "./renderer_context.h"
 
+#include <filesystem>
+
 #include "./vulkan_shaders.h"
 
 /**
@@ -55,7 +57,15 @@ boost::leaf::result<std::unique_ptr<RendererContext>> RendererContext::build(
         result->build_render_pass(vk::AttachmentLoadOp::eLoad, vk::AttachmentLoadOp::eLoad));
 
     LEAF_CHECK(result->build_pipeline_layout());
+
+    auto pipelines_start = std::chrono::steady_clock::now();
     LEAF_CHECK(result->build_pipelines());
+    result->pipelines_build_time_ = std::chrono::steady_clock::now() - pipelines_start;
+
+    logger::main->info(
+        "Pipelines built in {:.3f} ms ({} pipeline cache)",
+        result->pipelines_build_time_.count() * 1000.0,
+        engine->get_device()->get_pipeline_cache()->is_warm() ? "warm" : "cold");
 
     return result;
 }
@@ -64,6 +74,10 @@ const mff::vulkan::RenderPass* RendererContext::get_renderpass() const {
     return render_pass_main_.get();
 }
 
+std::chrono::duration<double> RendererContext::get_pipelines_build_time() const {
+    return pipelines_build_time_;
+}
+
 mff::vulkan::Device* RendererContext::get_device() {
     return engine_->get_device();
 }
@@ -73,7 +87,25 @@ vk::PipelineLayout RendererContext::get_pipeline_layout() {
 }
 
 vk::Pipeline RendererContext::get_over_pipeline() {
-    return pipeline_over_.get();
+    return get_pipeline(PipelineKind::Over);
+}
+
+vk::Pipeline RendererContext::get_pipeline(PipelineKind kind, bool indirect) {
+    auto index = static_cast<std::size_t>(kind);
+
+    return indirect ? pipelines_indirect_[index].get() : pipelines_[index].get();
+}
+
+vk::DescriptorSetLayout RendererContext::get_draw_data_set_layout() {
+    return draw_data_set_layout_.get();
+}
+
+bool RendererContext::supports_indirect() const {
+    return static_cast<bool>(pipelines_indirect_[static_cast<std::size_t>(PipelineKind::Over)]);
+}
+
+bool RendererContext::supports_multi_draw_indirect() const {
+    return supports_indirect() && engine_->get_device()->get_enabled_features().multiDrawIndirect;
 }
 
 boost::leaf::result<mff::vulkan::UniqueRenderPass> RendererContext::build_render_pass(
@@ -110,14 +142,28 @@ boost::leaf::result<mff::vulkan::UniqueRenderPass> RendererContext::build_render
 }
 
 boost::leaf::result<void> RendererContext::build_pipeline_layout() {
+    // per draw data for indirect drawing (unused by pipelines using push constants), the offset is
+    // dynamic because every frame has its draw data in different part of the upload ring
+    std::vector<vk::DescriptorSetLayoutBinding> draw_data_bindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex)
+    };
+
+    LEAF_AUTO_TO(
+        draw_data_set_layout_,
+        mff::to_result(
+            get_device()->get_handle().createDescriptorSetLayoutUnique(
+                vk::DescriptorSetLayoutCreateInfo({}, draw_data_bindings.size(), draw_data_bindings.data()))));
+
+    std::vector<vk::DescriptorSetLayout> set_layouts = {draw_data_set_layout_.get()};
+
     std::vector<vk::PushConstantRange> push_constant_range = {
         vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex, 0, sizeof(PushConstants))
     };
 
     vk::PipelineLayoutCreateInfo pipeline_layout_info(
         {},
-        0,
-        nullptr,
+        set_layouts.size(),
+        set_layouts.data(),
         push_constant_range.size(),
         push_constant_range.data());
 
@@ -129,7 +175,12 @@ boost::leaf::result<void> RendererContext::build_pipeline_layout() {
 }
 
 boost::leaf::result<void> RendererContext::build_pipelines() {
-    vk::StencilOpState stencil_op_state(
+    std::array<BuildPipelineInfo, kPIPELINE_KIND_COUNT> infos = {};
+
+    // over pipeline (stencil test disabled, the compare mask is dynamic)
+    auto& over_info = infos[static_cast<std::size_t>(PipelineKind::Over)];
+    over_info.dynamics_count = 3;
+    over_info.stencil_op = vk::StencilOpState(
         vk::StencilOp::eKeep,
         vk::StencilOp::eZero,
         vk::StencilOp::eKeep,
@@ -139,10 +190,80 @@ boost::leaf::result<void> RendererContext::build_pipelines() {
         0x1
     );
 
-    BuildPipelineInfo over_info = {};
-    over_info.dynamics_count = 3;
-    over_info.stencil_op = stencil_op_state;
-    LEAF_AUTO_TO(pipeline_over_,build_pipeline(over_info));
+    // stencil pipelines do not touch the color, they just count the coverage - the winding
+    // number (front faces increment, back faces decrement) or its parity
+    auto stencil_info = [](vk::StencilOpState front, vk::StencilOpState back) {
+        BuildPipelineInfo info = {};
+        info.dynamics_count = 2;
+        info.color_mask = {};
+        info.blend_enabled = false;
+        info.stencil_test_enabled = true;
+        info.stencil_op = front;
+        info.stencil_op_back = back;
+
+        return info;
+    };
+
+    auto stencil_op = [](vk::StencilOp op, std::uint32_t write_mask) {
+        return vk::StencilOpState(
+            vk::StencilOp::eKeep,
+            op,
+            vk::StencilOp::eKeep,
+            vk::CompareOp::eAlways,
+            0xFF,
+            write_mask,
+            0
+        );
+    };
+
+    infos[static_cast<std::size_t>(PipelineKind::StencilNonZero)] = stencil_info(
+        stencil_op(vk::StencilOp::eIncrementAndWrap, 0xFF),
+        stencil_op(vk::StencilOp::eDecrementAndWrap, 0xFF));
+    infos[static_cast<std::size_t>(PipelineKind::StencilEvenOdd)] = stencil_info(
+        stencil_op(vk::StencilOp::eInvert, kSTENCIL_FILL_BIT),
+        stencil_op(vk::StencilOp::eInvert, kSTENCIL_FILL_BIT));
+
+    // cover pipeline draws only where the stencil was set and resets it for the next path
+    auto& cover_info = infos[static_cast<std::size_t>(PipelineKind::Cover)];
+    cover_info.dynamics_count = 2;
+    cover_info.stencil_test_enabled = true;
+    cover_info.stencil_op = vk::StencilOpState(
+        vk::StencilOp::eKeep,
+        vk::StencilOp::eZero,
+        vk::StencilOp::eKeep,
+        vk::CompareOp::eNotEqual,
+        0xFF,
+        0xFF,
+        0
+    );
+
+    // the same as over pipeline, but the triangles are strips
+    auto& over_strip_info = infos[static_cast<std::size_t>(PipelineKind::OverStrip)];
+    over_strip_info = over_info;
+    over_strip_info.topology = vk::PrimitiveTopology::eTriangleStrip;
+    over_strip_info.primitive_restart = true;
+
+    for (std::size_t i = 0; i < kPIPELINE_KIND_COUNT; i++) {
+        LEAF_AUTO_TO(pipelines_[i], build_pipeline(infos[i]));
+    }
+
+    // the first instance is used as index of the draw data, so the device has to support it
+    // (and the SPIR-V of the indirect shader has to be present)
+    const std::string indirect_vertex_shader = "shaders/shader_indirect.vert.spv";
+
+    if (!get_device()->get_enabled_features().drawIndirectFirstInstance
+        || !std::filesystem::exists(indirect_vertex_shader)) {
+        logger::main->info("Indirect drawing is not supported, falling back to direct draws");
+
+        return {};
+    }
+
+    for (std::size_t i = 0; i < kPIPELINE_KIND_COUNT; i++) {
+        auto info = infos[i];
+        info.vertex_shader = indirect_vertex_shader;
+
+        LEAF_AUTO_TO(pipelines_indirect_[i], build_pipeline(info));
+    }
 
     return {};
 }
@@ -162,7 +283,7 @@ boost::leaf::result<vk::UniquePipeline> RendererContext::build_pipeline(BuildPip
         {},
         1.0f
     );
-    vk::PipelineInputAssemblyStateCreateInfo input_assembly_info({}, info.topology);
+    vk::PipelineInputAssemblyStateCreateInfo input_assembly_info({}, info.topology, info.primitive_restart);
 
     vk::PipelineColorBlendAttachmentState blend_attachment(
         info.blend_enabled,
@@ -190,9 +311,9 @@ boost::leaf::result<vk::UniquePipeline> RendererContext::build_pipeline(BuildPip
         false,
         vk::CompareOp::eAlways,
         false,
-        false, // TODO: find why not working with enabled
+        info.stencil_test_enabled,
         info.stencil_op,
-        info.stencil_op
+        info.stencil_op_back.value_or(info.stencil_op)
     );
 
     std::vector<vk::DynamicState> dynamic_enabled_states = {
@@ -216,7 +337,7 @@ boost::leaf::result<vk::UniquePipeline> RendererContext::build_pipeline(BuildPip
         vertex_input_attributes.size(),
         vertex_input_attributes.data());
 
-    LEAF_AUTO(vertex_shader_module, create_shader_module(get_device(), "shaders/shader.vert.spv"));
+    LEAF_AUTO(vertex_shader_module, create_shader_module(get_device(), info.vertex_shader));
     LEAF_AUTO(fragment_shader_module, create_shader_module(get_device(), "shaders/shader.frag.spv"));
 
     vk::PipelineShaderStageCreateInfo vertex_stage(
@@ -254,7 +375,9 @@ boost::leaf::result<vk::UniquePipeline> RendererContext::build_pipeline(BuildPip
         render_pass_main_->get_handle()
     );
 
-    return mff::to_result(get_device()->get_handle().createGraphicsPipelineUnique(nullptr, create_info));
+    return mff::to_result(get_device()->get_handle().createGraphicsPipelineUnique(
+        get_device()->get_pipeline_cache()->get_handle(),
+        create_info));
 }
 
 vk::Format RendererContext::get_color_attachment_format() const {
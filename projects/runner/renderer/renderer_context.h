@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <string>
 
 #include <mff/leaf.h>
 #include <mff/graphics/vulkan/render_pass.h>
@@ -22,6 +26,11 @@ struct Vertex {
     static std::array<vk::VertexInputAttributeDescription, 1> get_attribute_descriptions();
 };
 
+// the flattened points are written to the vertex buffers as they are (tightly packed positions)
+static_assert(
+    sizeof(Vertex) == sizeof(mff::Vector2f) && alignof(Vertex) == alignof(mff::Vector2f),
+    "Vertex has to be layout compatible with mff::Vector2f");
+
 /**
  * Push constants
  */
@@ -31,6 +40,37 @@ struct PushConstants {
     mff::Vector2f scale = mff::Vector2f::Zero();
 };
 
+/**
+ * Pipelines (ways) with which can be the triangles drawn
+ */
+enum class PipelineKind : std::uint32_t {
+    // draw the triangles over the image
+    Over = 0,
+    // only count the winding of triangles in stencil (nonzero fill rule)
+    StencilNonZero,
+    // only invert the stencil fill bit for every triangle (even-odd fill rule)
+    StencilEvenOdd,
+    // draw over the pixels with non zero stencil and reset their stencil to zero
+    Cover,
+    // draw the triangle strips over the image (the strips are separated by primitive restart index)
+    OverStrip,
+};
+
+const std::size_t kPIPELINE_KIND_COUNT = 5;
+
+/**
+ * Per draw data used by indirect drawing (read from storage buffer indexed by instance index, the
+ * layout matches std430 layout of DrawData in shader_indirect.vert)
+ */
+struct DrawData {
+    mff::Vector4f color = mff::Vector4f::Ones();
+    mff::Matrix2f transform = mff::Matrix2f::Identity();
+    mff::Vector2f position = mff::Vector2f::Zero();
+    mff::Vector2f padding_ = mff::Vector2f::Zero();
+};
+
+static_assert(sizeof(DrawData) == 48, "DrawData has to match the std430 layout used in shaders");
+
 /**
  * Class which encapsulates all the common rendering behaviour for our renderer
  *
@@ -86,6 +126,39 @@ public:
      */
     vk::Pipeline get_over_pipeline();
 
+    /**
+     * Get pipeline of specified kind
+     * @param kind
+     * @param indirect should the pipeline read the per draw data from storage buffer (descriptor
+     *                 set 0) indexed by instance index instead of push constants?
+     * @return
+     */
+    vk::Pipeline get_pipeline(PipelineKind kind, bool indirect = false);
+
+    /**
+     * Get layout of descriptor set with storage buffer of DrawData
+     * @return
+     */
+    vk::DescriptorSetLayout get_draw_data_set_layout();
+
+    /**
+     * Is the indirect drawing supported (by device and built shaders)?
+     * @return
+     */
+    bool supports_indirect() const;
+
+    /**
+     * Can be multiple draws issued by one indirect draw call?
+     * @return
+     */
+    bool supports_multi_draw_indirect() const;
+
+    /**
+     * How long did it take to build all the pipelines (with cold or warm pipeline cache)?
+     * @return
+     */
+    std::chrono::duration<double> get_pipelines_build_time() const;
+
 private:
     RendererContext() = default;
 
@@ -100,7 +173,11 @@ private:
     // Most of our pipelines are the much same except few informations
     struct BuildPipelineInfo {
         vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+        // restart the strip at the maximal index
+        bool primitive_restart = false;
         vk::StencilOpState stencil_op = vk::StencilOpState();
+        // used for back faces (if not set stencil_op is used)
+        std::optional<vk::StencilOpState> stencil_op_back = std::nullopt;
 
         /**
          * Color mask to use
@@ -137,6 +214,16 @@ private:
          * Should we color blending
          */
         bool blend_enabled = true;
+
+        /**
+         * Should we use stencil testing (stencil_op)
+         */
+        bool stencil_test_enabled = false;
+
+        /**
+         * Path to the vertex shader
+         */
+        std::string vertex_shader = "shaders/shader.vert.spv";
     };
 
     // Helper function
@@ -149,12 +236,15 @@ private:
      */
     mff::vulkan::UniqueRenderPass render_pass_main_ = nullptr;
 
+    vk::UniqueDescriptorSetLayout draw_data_set_layout_;
     vk::UniquePipelineLayout pipeline_layout_;
 
     /**
-     * Same as render passes - future proofing
+     * Pipelines indexed by PipelineKind (the indirect ones are built only if supported)
      */
-    vk::UniquePipeline pipeline_over_;
+    std::array<vk::UniquePipeline, kPIPELINE_KIND_COUNT> pipelines_;
+    std::array<vk::UniquePipeline, kPIPELINE_KIND_COUNT> pipelines_indirect_;
+    std::chrono::duration<double> pipelines_build_time_ = {};
 
     // used color format
     vk::Format color_format_;
@@ -0,0 +1,76 @@
+#include "./upload_ring.h"
+
+boost::leaf::result<std::unique_ptr<UploadRing>> UploadRing::build(
+    const mff::vulkan::Device* device,
+    vk::DeviceSize region_size,
+    std::uint32_t regions_count,
+    vk::BufferUsageFlags usage
+) {
+    struct enable_UploadRing : public UploadRing {};
+    std::unique_ptr<UploadRing> result = std::make_unique<enable_UploadRing>();
+
+    result->region_size_ = aligned_size(region_size);
+    result->regions_count_ = regions_count;
+
+    auto buffer_info = vk::BufferCreateInfo(
+        {},
+        result->region_size_ * regions_count,
+        usage,
+        vk::SharingMode::eExclusive
+    );
+
+    // written only by us and read by GPU
+    VmaAllocationCreateInfo allocation_info = {};
+    allocation_info.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    LEAF_AUTO_TO(result->buffer_, device->get_allocator()->create_buffer(buffer_info, allocation_info));
+
+    return result;
+}
+
+void UploadRing::begin_region(std::uint32_t region) {
+    region_start_ = region * region_size_;
+    head_ = region_start_;
+}
+
+std::optional<UploadRing::Allocation> UploadRing::allocate(vk::DeviceSize size) {
+    auto end = head_ + aligned_size(size);
+    if (end > region_start_ + region_size_) return std::nullopt;
+
+    Allocation result = {
+        buffer_->get_buffer(),
+        head_,
+        static_cast<char*>(buffer_->get_allocation_info().pMappedData) + head_
+    };
+
+    head_ = end;
+
+    return result;
+}
+
+std::optional<UploadRing::Allocation> UploadRing::push(const void* data, vk::DeviceSize size) {
+    auto allocation = allocate(size);
+
+    if (allocation && size > 0) {
+        memcpy(allocation->data, data, size);
+    }
+
+    return allocation;
+}
+
+vk::DeviceSize UploadRing::aligned_size(vk::DeviceSize size) {
+    return (size + kALIGNMENT - 1) / kALIGNMENT * kALIGNMENT;
+}
+
+vk::Buffer UploadRing::get_buffer() const {
+    return buffer_->get_buffer();
+}
+
+vk::DeviceSize UploadRing::get_region_size() const {
+    return region_size_;
+}
+
+std::uint32_t UploadRing::get_regions_count() const {
+    return regions_count_;
+}
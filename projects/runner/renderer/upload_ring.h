@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <mff/leaf.h>
+#include <mff/graphics/memory.h>
+#include <mff/graphics/vulkan/device.h>
+
+/**
+ * Host visible buffer split into regions - one for each frame in flight. Every frame linearly
+ * sub-allocates all the data it streams to GPU from its own region, so the region can be rewritten
+ * as soon as the frame which used it last time is rendered (without waiting for the other frames).
+ */
+class UploadRing {
+public:
+    /**
+     * Offset of every allocation is aligned to this (the biggest minStorageBufferOffsetAlignment
+     * allowed by Vulkan specification - so the allocations can be used by anything)
+     */
+    static constexpr vk::DeviceSize kALIGNMENT = 256;
+
+    /**
+     * Part of region allocated by allocate / push
+     */
+    struct Allocation {
+        vk::Buffer buffer;
+        vk::DeviceSize offset;
+        void* data;
+    };
+
+    /**
+     * Build the ring
+     * @param device on which device to allocate the buffer
+     * @param region_size size of one region
+     * @param regions_count number of regions (frames in flight)
+     * @param usage how is the buffer going to be used
+     * @return
+     */
+    static boost::leaf::result<std::unique_ptr<UploadRing>> build(
+        const mff::vulkan::Device* device,
+        vk::DeviceSize region_size,
+        std::uint32_t regions_count,
+        vk::BufferUsageFlags usage
+    );
+
+    /**
+     * Start allocating from the start of region (everything previously allocated from it is going
+     * to be overwritten)
+     * @param region
+     */
+    void begin_region(std::uint32_t region);
+
+    /**
+     * Allocate part of the current region
+     * @param size
+     * @return the allocation or std::nullopt if the region is full
+     */
+    std::optional<Allocation> allocate(vk::DeviceSize size);
+
+    /**
+     * Allocate part of the current region and copy the data into it
+     * @param data
+     * @param size
+     * @return the allocation or std::nullopt if the region is full
+     */
+    std::optional<Allocation> push(const void* data, vk::DeviceSize size);
+
+    /**
+     * Get the space needed in region by allocation of given size
+     * @param size
+     * @return
+     */
+    static vk::DeviceSize aligned_size(vk::DeviceSize size);
+
+    vk::Buffer get_buffer() const;
+    vk::DeviceSize get_region_size() const;
+    std::uint32_t get_regions_count() const;
+
+private:
+    UploadRing() = default;
+
+    vma::UniqueBuffer buffer_;
+    vk::DeviceSize region_size_ = 0;
+    std::uint32_t regions_count_ = 0;
+
+    // the current region [region_start_, region_start_ + region_size_) and the first free byte in it
+    vk::DeviceSize region_start_ = 0;
+    vk::DeviceSize head_ = 0;
+};
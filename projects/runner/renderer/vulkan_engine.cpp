@@ -3,6 +3,11 @@
 
 #include <mff/algorithms.h>
 
+/**
+ * File in which is the pipeline cache persisted (relative to working directory like the shaders)
+ */
+const std::string kPIPELINE_CACHE_FILE_NAME = "pipeline_cache.bin";
+
 bool QueueFamilyIndices::is_complete() {
     return graphics_family.has_value() && present_family.has_value() && transfer_family.has_value()
         && compute_family.has_value();
@@ -49,7 +54,8 @@ QueueFamilyIndices find_queue_families(
             indices.transfer_family = family;
         }
 
-        if (surface->is_supported(family)) {
+        // without surface (headless) there is nothing to present to, so any graphics queue will do
+        if (surface == nullptr ? family->supports_graphics() : surface->is_supported(family)) {
             indices.present_family = family;
         }
 
@@ -107,25 +113,79 @@ boost::leaf::result<std::unique_ptr<VulkanEngine>> VulkanEngine::build(
         [&](auto device) { return is_device_suitable(device, engine->surface_.get(), {}); }
     ).value());
 
-    auto queue_indices = find_queue_families(engine->physical_device_, engine->surface_.get());
+    LEAF_CHECK(engine->build_device({VK_KHR_SWAPCHAIN_EXTENSION_NAME}));
+
+    return std::move(engine);
+}
+
+/**
+ * How much do we want to use physical device of specified type (lower is better)
+ * @param type
+ * @return
+ */
+int get_device_type_rank(vk::PhysicalDeviceType type) {
+    switch (type) {
+        case vk::PhysicalDeviceType::eDiscreteGpu: return 0;
+        case vk::PhysicalDeviceType::eIntegratedGpu: return 1;
+        case vk::PhysicalDeviceType::eVirtualGpu: return 2;
+        case vk::PhysicalDeviceType::eCpu: return 3;
+        default: return 4;
+    }
+}
+
+boost::leaf::result<std::unique_ptr<VulkanEngine>> VulkanEngine::build_headless() {
+    logger::main->debug("Building headless VulkanEngine");
+    struct enable_VulkanEngine : public VulkanEngine {};
+    std::unique_ptr<VulkanEngine> engine = std::make_unique<enable_VulkanEngine>();
+
+    LEAF_AUTO_TO(engine->instance_, mff::vulkan::Instance::build(std::nullopt, {}, {}));
+
+    // prefer real GPUs, but accept anything which can render (e.g. lavapipe on CPU only machines)
+    for (auto device: engine->instance_->get_physical_devices()) {
+        if (!find_queue_families(device, nullptr).is_complete()) continue;
+
+        if (engine->physical_device_ == nullptr
+            || get_device_type_rank(device->get_type()) < get_device_type_rank(engine->physical_device_->get_type())) {
+            engine->physical_device_ = device;
+        }
+    }
+
+    if (engine->physical_device_ == nullptr) return LEAF_NEW_ERROR();
+
+    LEAF_CHECK(engine->build_device({}));
+
+    return std::move(engine);
+}
+
+boost::leaf::result<void> VulkanEngine::build_device(const std::vector<std::string>& extensions) {
+    auto queue_indices = find_queue_families(physical_device_, surface_.get());
+
+    // enable features needed for indirect drawing if they are available (otherwise we will fall
+    // back to direct draws)
+    const auto& supported_features = physical_device_->get_features();
+    vk::PhysicalDeviceFeatures features = {};
+    features.multiDrawIndirect = supported_features.multiDrawIndirect;
+    features.drawIndirectFirstInstance = supported_features.drawIndirectFirstInstance;
 
     // create device and queues
     LEAF_AUTO(
         device_result,
-        mff::vulkan::Device::build(
-            engine->physical_device_,
-            queue_indices.to_vector(),
-            {VK_KHR_SWAPCHAIN_EXTENSION_NAME}
-        ));
+        mff::vulkan::Device::build(physical_device_, queue_indices.to_vector(), extensions, features));
 
     std::vector<mff::vulkan::SharedQueue> queues_vec;
-    std::tie(engine->device_, queues_vec) = std::move(device_result);
+    std::tie(device_, queues_vec) = std::move(device_result);
 
-    engine->queues_ = Queues::from_vector(queues_vec);
+    // compiled pipelines are persisted between runs (saved when the device is destroyed)
+    LEAF_CHECK(device_->load_pipeline_cache(kPIPELINE_CACHE_FILE_NAME));
 
-    return std::move(engine);
+    queues_ = Queues::from_vector(queues_vec);
+
+    return {};
 }
 
+bool VulkanEngine::is_headless() const {
+    return surface_ == nullptr;
+}
 
 const mff::vulkan::Instance* VulkanEngine::get_instance() const {
     return instance_.get();
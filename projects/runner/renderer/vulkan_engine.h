@@ -43,7 +43,7 @@ struct Queues {
 /**
  * This class provides us with resources which are not specific to our vector graphics renderer
  * - Vulkan instance
- * - Vulkan surface
+ * - Vulkan surface (not available in headless mode)
  * - Vulkan device (+ allocator)
  * - Vulkan queues
  */
@@ -58,6 +58,20 @@ public:
         const std::shared_ptr<mff::window::Window>& window
     );
 
+    /**
+     * Build all specified Vulkan handles without any window (and surface) - the rendered images
+     * can be only read back. Any type of GPU is accepted (also software implementations like
+     * lavapipe).
+     * @return
+     */
+    static boost::leaf::result<std::unique_ptr<VulkanEngine>> build_headless();
+
+    /**
+     * Was the engine built without window?
+     * @return
+     */
+    bool is_headless() const;
+
     /**
      * Get Vulkan Instance
      * @return
@@ -103,6 +117,13 @@ public:
 private:
     VulkanEngine() = default;
 
+    /**
+     * Build device (and queues) for the chosen physical device
+     * @param extensions device extensions to enable
+     * @return
+     */
+    boost::leaf::result<void> build_device(const std::vector<std::string>& extensions);
+
     /**
      * Window on which we will initialize the vulkan context + draw (no multi window for now)
      */
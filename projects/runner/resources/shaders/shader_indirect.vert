@@ -0,0 +1,23 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 0) out vec4 fragColor;
+
+struct DrawData {
+    vec4 color;
+    mat2 transform;
+    vec2 position;
+};
+
+// indexed by first instance of the indirect draw command
+layout(std430, set = 0, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+} dd;
+
+void main() {
+    DrawData draw = dd.draws[gl_InstanceIndex];
+
+    gl_Position = vec4(draw.transform * inPosition + draw.position, 0.0, 1.0);
+    fragColor = draw.color;
+}
@@ -0,0 +1,277 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../canvas/tessellation.h"
+
+using canvas::FillRule;
+
+namespace {
+
+struct Contours {
+    std::vector<mff::Vector2f> points = {};
+    std::vector<std::size_t> sizes = {};
+
+    void add(const std::vector<mff::Vector2f>& contour) {
+        points.insert(std::end(points), std::begin(contour), std::end(contour));
+        sizes.push_back(contour.size());
+    }
+};
+
+double orientation(const mff::Vector2f& a, const mff::Vector2f& b, const mff::Vector2f& point) {
+    return (static_cast<double>(b[0]) - a[0]) * (static_cast<double>(point[1]) - a[1])
+        - (static_cast<double>(b[1]) - a[1]) * (static_cast<double>(point[0]) - a[0]);
+}
+
+/**
+ * The reference - winding number of the point (the contours are closed)
+ */
+int winding_number(const Contours& contours, const mff::Vector2f& point) {
+    int winding = 0;
+    std::size_t first = 0;
+
+    for (auto size: contours.sizes) {
+        for (std::size_t i = 0; i < size; i++) {
+            const auto& a = contours.points[first + i];
+            const auto& b = contours.points[first + (i + 1) % size];
+
+            if (a[1] <= point[1]) {
+                if (b[1] > point[1] && orientation(a, b, point) > 0.0) winding++;
+            } else if (b[1] <= point[1] && orientation(a, b, point) < 0.0) {
+                winding--;
+            }
+        }
+
+        first += size;
+    }
+
+    return winding;
+}
+
+/**
+ * Number of the triangles which contain the point
+ */
+int coverage(const canvas::FillTessellation& tessellation, const mff::Vector2f& point) {
+    int result = 0;
+
+    for (std::size_t i = 0; i < tessellation.indices.size(); i += 3) {
+        const auto& a = tessellation.vertices[tessellation.indices[i]];
+        const auto& b = tessellation.vertices[tessellation.indices[i + 1]];
+        const auto& c = tessellation.vertices[tessellation.indices[i + 2]];
+
+        auto ab = orientation(a, b, point);
+        auto bc = orientation(b, c, point);
+        auto ca = orientation(c, a, point);
+
+        if ((ab >= 0.0 && bc >= 0.0 && ca >= 0.0) || (ab <= 0.0 && bc <= 0.0 && ca <= 0.0)) result++;
+    }
+
+    return result;
+}
+
+/**
+ * Compare the tessellation with the winding number in random points of the bounding box
+ * @return the number of points which are covered wrongly (or more than once)
+ */
+int count_mismatches(const Contours& contours, FillRule fill_rule, int samples = 2000) {
+    auto tessellation = canvas::tessellate_fill(contours.points, contours.sizes, fill_rule);
+
+    mff::Vector2f min = contours.points.front();
+    mff::Vector2f max = contours.points.front();
+    for (const auto& point: contours.points) {
+        min = min.cwiseMin(point);
+        max = max.cwiseMax(point);
+    }
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> x(min[0], max[0]);
+    std::uniform_real_distribution<float> y(min[1], max[1]);
+
+    int mismatches = 0;
+
+    for (int i = 0; i < samples; i++) {
+        mff::Vector2f point(x(generator), y(generator));
+
+        auto winding = winding_number(contours, point);
+        bool filled = fill_rule == FillRule::EvenOdd ? winding % 2 != 0 : winding != 0;
+
+        if (coverage(tessellation, point) != (filled ? 1 : 0)) mismatches++;
+    }
+
+    return mismatches;
+}
+
+Contours random_polygons(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> coordinate(0.0f, 100.0f);
+    std::uniform_int_distribution<int> grid(0, 20);
+
+    Contours result;
+
+    for (unsigned c = 0; c < 1 + seed % 3; c++) {
+        std::vector<mff::Vector2f> contour;
+
+        // the points on grid make a lot of touching and collinear edges
+        for (unsigned i = 0; i < 4 + seed + c; i++) {
+            contour.push_back(
+                seed % 2
+                    ? mff::Vector2f(5.0f * grid(generator), 5.0f * grid(generator))
+                    : mff::Vector2f(coordinate(generator), coordinate(generator)));
+        }
+
+        result.add(contour);
+    }
+
+    return result;
+}
+
+}
+
+SCENARIO("sweep line tessellation fills the same area as the winding number") {
+    GIVEN("the contours which intersect each other and themselves") {
+        Contours bowtie;
+        bowtie.add({{0, 0}, {10, 10}, {10, 0}, {0, 10}});
+
+        Contours pentagram;
+        pentagram.add({{50, 0}, {79, 90}, {2, 35}, {98, 35}, {21, 90}});
+
+        Contours overlapping;
+        overlapping.add({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+        overlapping.add({{5, 0}, {15, 0}, {15, 10}, {5, 10}});
+
+        Contours nested;
+        nested.add({{0, 0}, {30, 0}, {30, 30}, {0, 30}});
+        nested.add({{10, 10}, {10, 20}, {20, 20}, {20, 10}});
+        nested.add({{12, 12}, {18, 12}, {18, 18}, {12, 18}});
+
+        WHEN("we tessellate them with both fill rules") {
+            THEN("every sampled point should be covered once exactly when it is filled") {
+                for (auto fill_rule: {FillRule::NonZero, FillRule::EvenOdd}) {
+                    REQUIRE(count_mismatches(bowtie, fill_rule) == 0);
+                    REQUIRE(count_mismatches(pentagram, fill_rule) == 0);
+                    REQUIRE(count_mismatches(overlapping, fill_rule) == 0);
+                    REQUIRE(count_mismatches(nested, fill_rule) == 0);
+                }
+            }
+        }
+    }
+
+    GIVEN("random polygons (with float coordinates and on grid)") {
+        WHEN("we tessellate them with both fill rules") {
+            THEN("every sampled point should be covered once exactly when it is filled") {
+                for (unsigned seed = 1; seed <= 40; seed++) {
+                    auto polygons = random_polygons(seed);
+
+                    for (auto fill_rule: {FillRule::NonZero, FillRule::EvenOdd}) {
+                        INFO("seed " << seed);
+                        REQUIRE(count_mismatches(polygons, fill_rule, 500) == 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("sweep line tessellation handles degenerate contours") {
+    GIVEN("no contours at all") {
+        Contours empty;
+
+        THEN("there should be no triangles") {
+            auto result = canvas::tessellate_fill(empty.points, empty.sizes, FillRule::NonZero);
+
+            REQUIRE(result.indices.empty());
+        }
+    }
+
+    GIVEN("contours of zero, one and two points") {
+        Contours degenerate;
+        degenerate.sizes.push_back(0);
+        degenerate.add({{1, 1}});
+        degenerate.add({{0, 0}, {10, 5}});
+
+        THEN("there should be no triangles") {
+            for (auto fill_rule: {FillRule::NonZero, FillRule::EvenOdd}) {
+                auto result = canvas::tessellate_fill(degenerate.points, degenerate.sizes, fill_rule);
+
+                REQUIRE(result.indices.empty());
+            }
+        }
+    }
+
+    GIVEN("contour with repeated and collinear points") {
+        Contours square;
+        square.add({{0, 0}, {5, 0}, {5, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 10}, {0, 0}});
+
+        THEN("it should be filled as the square") {
+            REQUIRE(count_mismatches(square, FillRule::NonZero) == 0);
+        }
+    }
+
+    GIVEN("contour without area") {
+        Contours line;
+        line.add({{0, 0}, {5, 5}, {10, 10}, {5, 5}});
+
+        THEN("there should be no triangles") {
+            auto result = canvas::tessellate_fill(line.points, line.sizes, FillRule::NonZero);
+
+            REQUIRE(result.indices.empty());
+        }
+    }
+
+    GIVEN("two squares with coincident edges") {
+        Contours same;
+        same.add({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+        same.add({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+
+        Contours opposite;
+        opposite.add({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+        opposite.add({{0, 10}, {10, 10}, {10, 0}, {0, 0}});
+
+        Contours adjacent;
+        adjacent.add({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+        adjacent.add({{10, 0}, {20, 0}, {20, 10}, {10, 10}});
+
+        THEN("the area should be covered once where it is filled") {
+            for (auto fill_rule: {FillRule::NonZero, FillRule::EvenOdd}) {
+                REQUIRE(count_mismatches(same, fill_rule) == 0);
+                REQUIRE(count_mismatches(opposite, fill_rule) == 0);
+                REQUIRE(count_mismatches(adjacent, fill_rule) == 0);
+            }
+
+            REQUIRE(canvas::tessellate_fill(same.points, same.sizes, FillRule::EvenOdd).indices.empty());
+            REQUIRE(canvas::tessellate_fill(opposite.points, opposite.sizes, FillRule::NonZero).indices.empty());
+        }
+    }
+}
+
+SCENARIO("intersecting contours are recognized") {
+    GIVEN("contours which do not touch") {
+        Contours nested;
+        nested.add({{0, 0}, {30, 0}, {30, 30}, {0, 30}});
+        nested.add({{10, 10}, {10, 20}, {20, 20}, {20, 10}});
+
+        THEN("they should not intersect") {
+            REQUIRE_FALSE(canvas::contours_intersect(nested.points, nested.sizes));
+        }
+    }
+
+    GIVEN("contours which cross, touch or go back along their edge") {
+        Contours bowtie;
+        bowtie.add({{0, 0}, {10, 10}, {10, 0}, {0, 10}});
+
+        Contours touching;
+        touching.add({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+        touching.add({{10, 5}, {20, 0}, {20, 10}});
+
+        Contours spike;
+        spike.add({{0, 0}, {10, 0}, {10, 10}, {10, 5}, {0, 10}});
+
+        THEN("they should intersect") {
+            REQUIRE(canvas::contours_intersect(bowtie.points, bowtie.sizes));
+            REQUIRE(canvas::contours_intersect(touching.points, touching.sizes));
+            REQUIRE(canvas::contours_intersect(spike.points, spike.sizes));
+        }
+    }
+}